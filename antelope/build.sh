@@ -4,4 +4,9 @@ if [ ! -d "$PWD/build" ]
 then
   mkdir build
 fi
-eosio-cpp -I="./include/"  -I="./external/"  -o="./build/token.brdg.wasm" -contract="token.brdg" -abigen -abigen_output="./build/token.brdg.abi" ./src/token.brdg.cpp
\ No newline at end of file
+flags=""
+if [ "$1" == "host-keccak" ]
+then
+  flags="-DKECCAK_HOST_FUNCTION=true"
+fi
+eosio-cpp $flags -I="./include/"  -I="./external/"  -o="./build/token.brdg.wasm" -contract="token.brdg" -abigen -abigen_output="./build/token.brdg.abi" ./src/token.brdg.cpp
\ No newline at end of file
@@ -0,0 +1,111 @@
+#pragma once
+
+namespace evm_bridge
+{
+  /**
+   * Solidity ABI calldata encoder, sizes the call up front & writes it into a single buffer
+   */
+  namespace abi
+  {
+    using address = eosio::checksum160;
+    using string = std::string_view;
+    template <typename T>
+    using array = std::vector<T>;
+    using selector = std::array<uint8_t, 4>;
+
+    inline constexpr size_t paddedLength(size_t length)
+    {
+      return (length + WORD_SIZE - 1) / WORD_SIZE * WORD_SIZE;
+    }
+
+    // Bytes an argument adds after the head (only dynamic types have a tail)
+    inline size_t tailSize(const uint256_t&) { return 0; }
+    inline size_t tailSize(const address&) { return 0; }
+    inline size_t tailSize(const string& value) { return WORD_SIZE + paddedLength(value.size()); }
+
+    // Length, then the elements encoded like a tuple: heads first, tails of dynamic elements after them
+    template <typename T>
+    inline size_t tailSize(const array<T>& values)
+    {
+      size_t size = WORD_SIZE + WORD_SIZE * values.size();
+      for(const auto& value : values) size += tailSize(value);
+      return size;
+    }
+
+    struct writer {
+      uint8_t* args;
+      uint8_t* head;
+      size_t tail_offset;
+
+      void write(const uint256_t& value)
+      {
+        intx::be::unsafe::store(head, value);
+        head += WORD_SIZE;
+      }
+
+      void write(const address& value)
+      {
+        const auto bytes = value.extract_as_byte_array();
+        memcpy(head + WORD_SIZE - bytes.size(), bytes.data(), bytes.size());
+        head += WORD_SIZE;
+      }
+
+      // Head holds the offset of the tail, tail holds the length then the padded bytes
+      void write(const string& value)
+      {
+        intx::be::unsafe::store(head, uint256_t(tail_offset));
+        head += WORD_SIZE;
+        intx::be::unsafe::store(args + tail_offset, uint256_t(value.size()));
+        memcpy(args + tail_offset + WORD_SIZE, value.data(), value.size());
+        tail_offset += tailSize(value);
+      }
+
+      // Head holds the offset of the tail, tail holds the length then the elements, whose offsets start after the length
+      template <typename T>
+      void write(const array<T>& values)
+      {
+        intx::be::unsafe::store(head, uint256_t(tail_offset));
+        head += WORD_SIZE;
+        intx::be::unsafe::store(args + tail_offset, uint256_t(values.size()));
+        uint8_t* elements_start = args + tail_offset + WORD_SIZE;
+        writer elements { elements_start, elements_start, WORD_SIZE * values.size() };
+        for(const auto& value : values) elements.write(value);
+        tail_offset += tailSize(values);
+      }
+    };
+
+    template <typename... Types>
+    std::vector<uint8_t> encode(const selector& fnsig, const Types&... values)
+    {
+      const size_t head_size = WORD_SIZE * sizeof...(Types);
+      std::vector<uint8_t> data(fnsig.size() + head_size + (tailSize(values) + ... + 0)); // zero filled so padding is already there
+      memcpy(data.data(), fnsig.data(), fnsig.size());
+
+      writer out { data.data() + fnsig.size(), data.data() + fnsig.size(), head_size };
+      (out.write(values), ...);
+      return data;
+    }
+
+    // A Solidity function: its selector & argument types, so each call site is type checked at compile time
+    template <typename... Types>
+    struct call {
+      selector fnsig;
+
+      std::vector<uint8_t> encode(const Types&... values) const
+      {
+        return abi::encode<Types...>(fnsig, values...);
+      }
+    };
+  } // namespace abi
+
+  // TokenBridge.bridgeTo(address token, address receiver, uint amount, string sender)
+  static constexpr abi::call<abi::address, abi::address, uint256_t, abi::string> EVM_BRIDGE_CALL { EVM_BRIDGE_SIGNATURE };
+  // TokenBridge.bridgeToBatch(address[] tokens, address[] receivers, uint[] amounts, string[] senders, string[] antelope_tokens, string[] antelope_symbols)
+  static constexpr abi::call<abi::array<abi::address>, abi::array<abi::address>, abi::array<uint256_t>, abi::array<abi::string>, abi::array<abi::string>, abi::array<abi::string>> EVM_BRIDGE_BATCH_CALL { EVM_BRIDGE_BATCH_SIGNATURE };
+  // TokenBridge.requestsSuccessful(uint[] ids)
+  static constexpr abi::call<abi::array<uint256_t>> EVM_SUCCESS_CALLBACKS_CALL { EVM_SUCCESS_CALLBACKS_SIGNATURE };
+  // TokenBridge.refundsSuccessful(uint[] ids)
+  static constexpr abi::call<abi::array<uint256_t>> EVM_REFUND_CALLBACKS_CALL { EVM_REFUND_CALLBACKS_SIGNATURE };
+  // PairBridgeRegister.signRegistrationRequest(uint id, uint antelope_decimals, string account, string issuer, string symbol)
+  static constexpr abi::call<uint256_t, uint256_t, abi::string, abi::string, abi::string> EVM_SIGN_REGISTRATION_CALL { EVM_SIGN_REGISTRATION_SIGNATURE };
+} // namespace evm_bridge
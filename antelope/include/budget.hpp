@@ -0,0 +1,37 @@
+#pragma once
+
+namespace evm_bridge {
+    //======================== Notify budget ========================
+    // Returned by the notify actions so the crank knows whether to push again right away
+    struct notify_result {
+        uint64_t processed;
+        uint64_t pending;
+
+        EOSLIB_SERIALIZE(notify_result, (processed)(pending));
+    };
+
+    // Keeps track of the estimated cost spent by a notify action so it stops before running out of CPU
+    class notify_budget {
+        public:
+            notify_budget(uint64_t max_items, uint64_t budget) : max_items(max_items), remaining(budget) {};
+
+            // Checks there is enough budget left to handle one more item of the given cost
+            bool can_process(uint64_t item_cost) const {
+                return processed < max_items && item_cost <= remaining;
+            }
+
+            void spend(uint64_t cost) {
+                remaining = (cost > remaining) ? 0 : remaining - cost;
+            }
+
+            void spend_slot_reads(uint64_t count) { spend(count * SLOT_READ_COST); slots_read += count; }
+            void spend_inline_actions(uint64_t count) { spend(count * INLINE_ACTION_COST); inline_actions += count; }
+
+            uint64_t max_items;
+            uint64_t remaining;
+            uint64_t processed = 0;
+            uint64_t skipped = 0;
+            uint64_t slots_read = 0;
+            uint64_t inline_actions = 0;
+    };
+}
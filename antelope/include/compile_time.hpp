@@ -0,0 +1,118 @@
+#pragma once
+
+namespace evm_bridge
+{
+  /**
+   * Compile time helpers, so constant EVM slots & selectors cost nothing at runtime
+   */
+  constexpr uint8_t hexNibble(char c)
+  {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return 0;
+  }
+
+  // Decodes a hex string literal (without 0x) into bytes
+  template <size_t L>
+  constexpr std::array<uint8_t, (L - 1) / 2> hexToBytes(const char (&hex)[L])
+  {
+    static_assert(L % 2 == 1, "Hex string must have an even number of characters");
+    std::array<uint8_t, (L - 1) / 2> output = {};
+    for (size_t i = 0; i < output.size(); i++) {
+      output[i] = (hexNibble(hex[2 * i]) << 4) | hexNibble(hex[2 * i + 1]);
+    }
+    return output;
+  }
+
+  /**
+   * Keccak-f[1600] & Keccak-256 (Ethereum padding)
+   */
+  namespace keccak
+  {
+    constexpr uint64_t ROUND_CONSTANTS[24] = {
+      0x0000000000000001ULL, 0x0000000000008082ULL, 0x800000000000808aULL, 0x8000000080008000ULL,
+      0x000000000000808bULL, 0x0000000080000001ULL, 0x8000000080008081ULL, 0x8000000000008009ULL,
+      0x000000000000008aULL, 0x0000000000000088ULL, 0x0000000080008009ULL, 0x000000008000000aULL,
+      0x000000008000808bULL, 0x800000000000008bULL, 0x8000000000008089ULL, 0x8000000000008003ULL,
+      0x8000000000008002ULL, 0x8000000000000080ULL, 0x000000000000800aULL, 0x800000008000000aULL,
+      0x8000000080008081ULL, 0x8000000000008080ULL, 0x0000000080000001ULL, 0x8000000080008008ULL
+    };
+    constexpr uint8_t ROTATIONS[24] = { 1, 3, 6, 10, 15, 21, 28, 36, 45, 55, 2, 14, 27, 41, 56, 8, 25, 43, 62, 18, 39, 61, 20, 44 };
+    constexpr uint8_t LANES[24] = { 10, 7, 11, 17, 18, 3, 5, 16, 8, 21, 24, 4, 15, 23, 19, 13, 12, 2, 20, 14, 22, 9, 6, 1 };
+    constexpr size_t RATE = 136;
+
+    constexpr uint64_t rotl(uint64_t x, uint8_t n)
+    {
+      return (x << n) | (x >> (64 - n));
+    }
+
+    constexpr void permute(std::array<uint64_t, 25>& state)
+    {
+      for (size_t round = 0; round < 24; round++) {
+        // Theta
+        uint64_t c[5] = {};
+        for (size_t x = 0; x < 5; x++) {
+          c[x] = state[x] ^ state[x + 5] ^ state[x + 10] ^ state[x + 15] ^ state[x + 20];
+        }
+        for (size_t x = 0; x < 5; x++) {
+          const uint64_t d = c[(x + 4) % 5] ^ rotl(c[(x + 1) % 5], 1);
+          for (size_t y = 0; y < 25; y += 5) {
+            state[y + x] ^= d;
+          }
+        }
+        // Rho & Pi
+        uint64_t current = state[1];
+        for (size_t i = 0; i < 24; i++) {
+          const uint64_t next = state[LANES[i]];
+          state[LANES[i]] = rotl(current, ROTATIONS[i]);
+          current = next;
+        }
+        // Chi
+        for (size_t y = 0; y < 25; y += 5) {
+          uint64_t row[5] = {};
+          for (size_t x = 0; x < 5; x++) row[x] = state[y + x];
+          for (size_t x = 0; x < 5; x++) state[y + x] = row[x] ^ (~row[(x + 1) % 5] & row[(x + 2) % 5]);
+        }
+        // Iota
+        state[0] ^= ROUND_CONSTANTS[round];
+      }
+    }
+
+    template <size_t N>
+    constexpr std::array<uint8_t, 32> hash(const std::array<uint8_t, N>& input)
+    {
+      std::array<uint64_t, 25> state = {};
+      size_t offset = 0;
+
+      // Absorb every full block, then the padded last one
+      for (; offset + RATE <= N; offset += RATE) {
+        for (size_t i = 0; i < RATE; i++) {
+          state[i / 8] ^= uint64_t(input[offset + i]) << (8 * (i % 8));
+        }
+        permute(state);
+      }
+      for (size_t i = 0; offset + i < N; i++) {
+        state[i / 8] ^= uint64_t(input[offset + i]) << (8 * (i % 8));
+      }
+      state[(N - offset) / 8] ^= uint64_t(0x01) << (8 * ((N - offset) % 8));
+      state[(RATE - 1) / 8] ^= uint64_t(0x80) << (8 * ((RATE - 1) % 8));
+      permute(state);
+
+      // Squeeze
+      std::array<uint8_t, 32> output = {};
+      for (size_t i = 0; i < 32; i++) {
+        output[i] = uint8_t(state[i / 8] >> (8 * (i % 8)));
+      }
+      return output;
+    }
+  } // namespace keccak
+
+  // Slot of the first element of the Solidity dynamic array declared at storage index `index`: keccak256(uint256(index))
+  constexpr std::array<uint8_t, 32> arrayBaseSlot(uint8_t index)
+  {
+    std::array<uint8_t, 32> key = {};
+    key[31] = index;
+    return keccak::hash(key);
+  }
+} // namespace evm_bridge
@@ -3,6 +3,11 @@
 // Adds superpower testing functions (required for running cpp tests/clearing data in contract)
 #define TESTING true
 
+// Hash with the chain's keccak host function instead of the in contract implementation (set by build.sh host-keccak)
+#ifndef KECCAK_HOST_FUNCTION
+#define KECCAK_HOST_FUNCTION false
+#endif
+
 // Crypto
 #define MBEDTLS_ASN1_OCTET_STRING 0x04
 
@@ -20,16 +25,47 @@ namespace evm_bridge
   static constexpr eosio::name ESCROW = eosio::name("escrow.brdg");
   static constexpr eosio::name EVM_SYSTEM_CONTRACT = eosio::name("eosio.evm");
   static constexpr eosio::name TOKEN_CONTRACT = eosio::name("eosio.token");
-  static constexpr uint64_t SIGN_REGISTRATION_GAS = 250000; // Todo: find exact needed gas
-  static constexpr uint64_t REFUND_CB_GAS = 250000; // Todo: find exact needed gas
-  static constexpr uint64_t SUCCESS_CB_GAS = 250000; // Todo: find exact needed gas
-  static constexpr uint64_t BRIDGE_GAS = 250000; // Todo: find exact needed gas
-  static constexpr auto EVM_SUCCESS_CALLBACK_SIGNATURE = "0fbc79cd";
-  static constexpr auto EVM_REFUND_CALLBACK_SIGNATURE = "dc2fdf9f";
-  static constexpr auto EVM_BRIDGE_SIGNATURE = "7d056de7";
-  static constexpr auto EVM_SIGN_REGISTRATION_SIGNATURE = "a1d22913";
+  // Default EVM gas limits, estimates no profile run has measured yet: `setgas` replaces them with the figures evm/test/GasProfile.js measures
+  static constexpr uint64_t SIGN_REGISTRATION_GAS = 250000;
+  static constexpr uint64_t REFUND_CB_GAS = 250000;
+  static constexpr uint64_t SUCCESS_CB_GAS = 250000;
+  static constexpr uint64_t REFUND_CB_ITEM_GAS = 100000; // per id of a refundsSuccessful call
+  static constexpr uint64_t SUCCESS_CB_ITEM_GAS = 100000; // per id of a requestsSuccessful call
+  static constexpr uint64_t BRIDGE_BATCH_GAS = 100000; // a bridgeTo call counts as a batch of one
+  static constexpr uint64_t BRIDGE_BATCH_ITEM_GAS = 150000;
+  static constexpr uint64_t MAX_CALL_GAS = 30000000; // a gas limit set or computed above it is rejected
+  static constexpr uint64_t MAX_BRIDGE_BATCH = 50; // max deposits per bridgeToBatch call
+  // 4 bytes function selectors, decoded at compile time
+  static constexpr auto EVM_SUCCESS_CALLBACKS_SIGNATURE = hexToBytes("f8d5bb4c");
+  static constexpr auto EVM_REFUND_CALLBACKS_SIGNATURE = hexToBytes("caa99f7b");
+  static constexpr auto EVM_BRIDGE_SIGNATURE = hexToBytes("7d056de7");
+  static constexpr auto EVM_BRIDGE_BATCH_SIGNATURE = hexToBytes("c13f0dfe");
+  static constexpr auto EVM_SIGN_REGISTRATION_SIGNATURE = hexToBytes("a1d22913");
+  // Notify actions cost model, in abstract units (an eosio.evm raw call costs roughly 5 accountstate reads)
+  static constexpr uint64_t SLOT_READ_COST = 1;
+  static constexpr uint64_t INLINE_ACTION_COST = 5;
+  static constexpr uint64_t DEFAULT_NOTIFY_MAX_ITEMS = 10;
+  static constexpr uint64_t DEFAULT_NOTIFY_BUDGET = 200;
+  static constexpr uint64_t NOTIFY_PARTITIONS = 8; // dedupe rows of a notify queue, shard counts must divide it
+  static constexpr uint64_t DEDUPE_WINDOW_WORDS = 4; // in flight ids tracked past each dedupe partition watermark, 64 per word
+  static constexpr uint64_t MAX_STORAGE_STRING_LENGTH = 256; // max bytes read from a long EVM Storage string
+  static constexpr uint64_t MAX_STORAGE_RANGE_STEP = 2; // max slots a storage range steps forward before it seeks, so it steps over the Request requested_at no read needs
   static constexpr uint8_t STORAGE_BRIDGE_REQUEST_INDEX = 4;
   static constexpr uint8_t STORAGE_BRIDGE_REFUND_INDEX = 5;
+  static constexpr uint8_t STORAGE_BRIDGE_REQUEST_ID_INDEX = 7; // next request id
+  static constexpr uint8_t STORAGE_BRIDGE_REFUND_ID_INDEX = 8; // next refund id
   static constexpr uint8_t STORAGE_REGISTER_REQUEST_INDEX = 4;
   static constexpr uint8_t STORAGE_REGISTER_PAIR_INDEX = 3;
+  // PairBridgeRegister mappings to pairs[] & requests[] index + 1
+  static constexpr uint8_t STORAGE_REGISTER_PAIR_BY_TOKEN_INDEX = 8;
+  static constexpr uint8_t STORAGE_REGISTER_PAIR_BY_ACCOUNT_INDEX = 9;
+  static constexpr uint8_t STORAGE_REGISTER_PAIR_BY_SYMBOL_INDEX = 10;
+  static constexpr uint8_t STORAGE_REGISTER_REQUEST_BY_SYMBOL_INDEX = 11;
+  static constexpr uint8_t STORAGE_REGISTER_PAIR_BY_ID_INDEX = 12; // keyed by pair id
+  static constexpr uint64_t MAX_QUERY_ITEMS = 100; // max items per read only query page
+  // Dynamic arrays base slots (keccak256 of their storage index), hashed at compile time
+  static constexpr auto STORAGE_BRIDGE_REQUEST_SLOT = arrayBaseSlot(STORAGE_BRIDGE_REQUEST_INDEX);
+  static constexpr auto STORAGE_BRIDGE_REFUND_SLOT = arrayBaseSlot(STORAGE_BRIDGE_REFUND_INDEX);
+  static constexpr auto STORAGE_REGISTER_REQUEST_SLOT = arrayBaseSlot(STORAGE_REGISTER_REQUEST_INDEX);
+  static constexpr auto STORAGE_REGISTER_PAIR_SLOT = arrayBaseSlot(STORAGE_REGISTER_PAIR_INDEX);
 }
\ No newline at end of file
@@ -0,0 +1,60 @@
+#pragma once
+
+namespace evm_bridge
+{
+  /**
+   * Exact decimal conversions between Antelope assets & EVM token amounts
+   */
+  static constexpr uint8_t MAX_ANTELOPE_PRECISION = 18;
+  static constexpr uint8_t MAX_EVM_DECIMALS = 36;
+
+  // 10^0 to 10^36, all below 2^128 so the table is built with native 128 bits integers at compile time
+  constexpr std::array<uint256_t, MAX_EVM_DECIMALS + 1> buildPow10Table()
+  {
+    std::array<uint256_t, MAX_EVM_DECIMALS + 1> table = {};
+    unsigned __int128 value = 1;
+    for (size_t i = 0; i < table.size(); i++) {
+      table[i] = uint256_t(intx::uint128(value));
+      value *= 10;
+    }
+    return table;
+  }
+
+  static constexpr std::array<uint256_t, MAX_EVM_DECIMALS + 1> POW10 = buildPow10Table();
+
+  inline void checkDecimals(uint8_t antelope_precision, uint64_t evm_decimals)
+  {
+    eosio::check(antelope_precision <= MAX_ANTELOPE_PRECISION, "Antelope precision is too high");
+    eosio::check(evm_decimals <= MAX_EVM_DECIMALS, "EVM decimals are too high");
+  }
+
+  // Antelope asset amount to EVM amount, refuses to drop decimals the EVM token cannot hold
+  inline uint256_t toEvmAmount(uint64_t amount, uint8_t antelope_precision, uint64_t evm_decimals)
+  {
+    checkDecimals(antelope_precision, evm_decimals);
+    if (evm_decimals >= antelope_precision) {
+      return uint256_t(amount) * POW10[evm_decimals - antelope_precision]; // at most 2^64 * 10^36, no overflow
+    }
+    const uint64_t divisor = static_cast<uint64_t>(POW10[antelope_precision - evm_decimals]);
+    eosio::check(amount % divisor == 0, "Amount has more decimal places than the EVM token");
+    return uint256_t(amount / divisor);
+  }
+
+  // EVM amount to Antelope asset amount, checked to be exact & to fit an asset
+  inline uint64_t toAntelopeAmount(const uint256_t& amount, uint8_t antelope_precision, uint64_t evm_decimals)
+  {
+    checkDecimals(antelope_precision, evm_decimals);
+    uint256_t scaled;
+    if (evm_decimals >= antelope_precision) {
+      const uint256_t& divisor = POW10[evm_decimals - antelope_precision];
+      scaled = amount / divisor;
+      eosio::check(scaled * divisor == amount, "Amount has more decimal places than the Antelope token");
+    } else {
+      const uint256_t& multiplier = POW10[antelope_precision - evm_decimals];
+      eosio::check(amount <= uint256_t(eosio::asset::max_amount) / multiplier, "Amount is too high to bridge");
+      scaled = amount * multiplier;
+    }
+    eosio::check(scaled <= uint256_t(eosio::asset::max_amount), "Amount is too high to bridge");
+    return static_cast<uint64_t>(scaled);
+  }
+} // namespace evm_bridge
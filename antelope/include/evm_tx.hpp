@@ -0,0 +1,121 @@
+#pragma once
+
+namespace evm_bridge
+{
+  /**
+   * Single pass RLP encoder for the legacy EIP-155 transactions sent to eosio.evm raw
+   * Output is byte-identical to rlp::encode(nonce, gas_price, gas_limit, to, value, data, chain_id, 0, 0)
+   */
+  namespace rlp_tx
+  {
+    inline size_t significantBytes(uint64_t value)
+    {
+      return value == 0 ? 0 : 8 - (__builtin_clzll(value) / 8);
+    }
+
+    inline size_t significantBytes(const uint256_t& value)
+    {
+      return value == 0 ? 0 : intx::count_significant_words<uint8_t>(value);
+    }
+
+    // Size of an RLP string header for a payload of `length` bytes whose first byte is `first`
+    inline size_t headerSize(size_t length, uint8_t first)
+    {
+      if (length == 1 && first < 0x80) return 0;
+      return length < 56 ? 1 : 1 + significantBytes(uint64_t(length));
+    }
+
+    inline size_t scalarSize(uint64_t value)
+    {
+      return value != 0 && value < 0x80 ? 1 : 1 + significantBytes(value);
+    }
+
+    inline size_t scalarSize(const uint256_t& value)
+    {
+      return value != 0 && value < 0x80 ? 1 : 1 + significantBytes(value);
+    }
+
+    inline size_t bytesSize(const uint8_t* bytes, size_t length)
+    {
+      return headerSize(length, length ? bytes[0] : 0) + length;
+    }
+
+    struct writer {
+      int8_t* out;
+
+      void byte(uint8_t value)
+      {
+        *out++ = static_cast<int8_t>(value);
+      }
+
+      void bigEndian(uint64_t value, size_t length)
+      {
+        for (size_t i = length; i > 0; i--) byte(uint8_t(value >> (8 * (i - 1))));
+      }
+
+      void length(size_t length, uint8_t offset)
+      {
+        if (length < 56) {
+          byte(offset + length);
+          return;
+        }
+        const size_t length_size = significantBytes(uint64_t(length));
+        byte(offset + 55 + length_size);
+        bigEndian(length, length_size);
+      }
+
+      void scalar(uint64_t value)
+      {
+        if (value != 0 && value < 0x80) return byte(value);
+        const size_t size = significantBytes(value);
+        byte(0x80 + size);
+        bigEndian(value, size);
+      }
+
+      void scalar(const uint256_t& value)
+      {
+        if (value != 0 && value < 0x80) return byte(static_cast<uint8_t>(value));
+        const size_t size = significantBytes(value);
+        byte(0x80 + size);
+        uint8_t word[32] = {};
+        intx::be::store(word, value);
+        memcpy(out, word + 32 - size, size);
+        out += size;
+      }
+
+      void bytes(const uint8_t* bytes, size_t size)
+      {
+        if (size != 1 || bytes[0] >= 0x80) length(size, 0x80);
+        memcpy(out, bytes, size);
+        out += size;
+      }
+    };
+  } // namespace rlp_tx
+
+  // Encodes an unsigned EIP-155 transaction into a single exactly sized buffer, ready for eosio.evm raw
+  inline std::vector<int8_t> encodeTransaction(uint64_t nonce, const uint256_t& gas_price, uint64_t gas_limit, const eosio::checksum160& to, const uint256_t& value, const std::vector<uint8_t>& data, uint64_t chain_id)
+  {
+    const auto to_bytes = to.extract_as_byte_array();
+
+    // First pass: payload size
+    const size_t payload_size = rlp_tx::scalarSize(nonce) + rlp_tx::scalarSize(gas_price) + rlp_tx::scalarSize(gas_limit)
+      + rlp_tx::bytesSize(to_bytes.data(), to_bytes.size()) + rlp_tx::scalarSize(value)
+      + rlp_tx::bytesSize(data.data(), data.size()) + rlp_tx::scalarSize(chain_id) + 2; // r & s are empty
+    const size_t list_header_size = payload_size < 56 ? 1 : 1 + rlp_tx::significantBytes(uint64_t(payload_size));
+
+    // Second pass: write it
+    std::vector<int8_t> tx(list_header_size + payload_size);
+    rlp_tx::writer out { tx.data() };
+    out.length(payload_size, 0xc0);
+    out.scalar(nonce);
+    out.scalar(gas_price);
+    out.scalar(gas_limit);
+    out.bytes(to_bytes.data(), to_bytes.size());
+    out.scalar(value);
+    out.bytes(data.data(), data.size());
+    out.scalar(chain_id);
+    out.scalar(uint64_t(0));
+    out.scalar(uint64_t(0));
+    return tx;
+  }
+} // namespace evm_bridge
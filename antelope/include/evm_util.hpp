@@ -24,7 +24,7 @@ namespace evm_bridge
     return res;
   }
 
-  template<unsigned N, typename T>
+  template<size_t N, typename T>
   static inline std::string bin2hex(const std::array<T, N>& bin)
   {
     std::string res;
@@ -120,6 +120,11 @@ namespace evm_bridge
     return toChecksum160( toBin(input) );
   }
 
+  // Do not use for addresses, only key for Account States
+  static inline uint256_t bytesToValue(const std::array<uint8_t, 32U>& input) {
+    return intx::be::unsafe::load<uint256_t>(input.data());
+  }
+
   // Do not use for addresses, only key for Account States
   static inline uint256_t checksum256ToValue(const eosio::checksum256& input) {
     std::array<uint8_t, 32U> output = {};
@@ -142,44 +147,23 @@ namespace evm_bridge
         return toChecksum256(array_slot + position + (property_count * (i)));
   }
 
-  static inline unsigned char decodeHex(char c)
-  {
-      if ('0' <= c && c <= '9') { return c      - '0'; }
-      if ('a' <= c && c <= 'f') { return c + 10 - 'a'; }
-      if ('A' <= c && c <= 'F') { return c + 10 - 'A'; }
-      return 0;
-  }
-
-  static inline std::string decodeHex(std::string const & s)
-  {
-      std::string result;
-      result.reserve(s.size() / 2);
-
-      for (std::size_t i = 0; i < s.size() / 2; ++i)
-      {
-          unsigned char n = decodeHex(s[2 * i]) * 16 + decodeHex(s[2 * i + 1]);
-          result += n;
-      }
-
-      return result;
-  }
-
-  // Parses a string from an EVM Storage string (less than < 32bytes only)
-  inline std::string parseStringFromStorage(const uint256_t checksum){
-    const size_t length = shrink<size_t>(checksum.lo) / 2; // get length from last 32 bytes as size_t
-    std::vector<uint8_t> bs = intx::to_byte_string(checksum.hi); // get first 32 bytes
-    bs.resize(length); // remove trailing 0
-    return decodeHex(bin2hex(bs)); // convert to string
+  // Views a short EVM Storage string (< 32 bytes), stored left aligned with its length * 2 in the last byte
+  inline std::string_view parseShortStringFromStorage(const uint256_t& word, std::array<uint8_t, 32u>& buffer){
+    intx::be::unsafe::store(buffer.data(), word);
+    eosio::check((buffer[31] & 1) == 0, "Storage string is longer than 31 bytes");
+    return std::string_view(reinterpret_cast<const char*>(buffer.data()), buffer[31] / 2);
   }
 
   // Parses an Antelope name from an EVM Storage string
-  inline eosio::name parseNameFromStorage(const uint256_t checksum){
-    return eosio::name(parseStringFromStorage(checksum)); // convert to name
+  inline eosio::name parseNameFromStorage(const uint256_t& word){
+    std::array<uint8_t, 32u> buffer;
+    return eosio::name(parseShortStringFromStorage(word, buffer));
   }
 
   // Parses an Antelope symbol code from an EVM Storage string
-  inline eosio::symbol_code parseSymbolCodeFromStorage(const uint256_t checksum){
-    return eosio::symbol_code(parseStringFromStorage(checksum)); // convert to symbol code
+  inline eosio::symbol_code parseSymbolCodeFromStorage(const uint256_t& word){
+    std::array<uint8_t, 32u> buffer;
+    return eosio::symbol_code(parseShortStringFromStorage(word, buffer));
   }
 
 
@@ -192,36 +176,6 @@ namespace evm_bridge
     return bs;
   }
 
-  template <typename T, typename U>
-  static inline void insertElementPosition(std::vector<T> *data, U position){
-        std::vector<T> string_position_bs = pad(intx::to_byte_string(position), 32, true);
-        data->insert(data->end(), string_position_bs.begin(), string_position_bs.end());
-  }
-
-  template <typename T, typename... Args>
-  static inline void insertElementPositions(std::vector<T> *data, Args... args){
-    (insertElementPosition(data, args), ...);
-  }
-
-
-  template <typename T>
-  static inline void insertString(std::vector<T> *data, std::string value, uint64_t length){
-    std::vector<T> string_size = pad(intx::to_byte_string(length), 32, true);
-    std::vector<T> str(value.begin(), value.end());
-    str = pad(str, 32, false);
-    data->insert(data->end(), string_size.begin(), string_size.end());
-    data->insert(data->end(), str.begin(), str.end());
-  }
-
-  template <typename T>
-  static inline void insertName(std::vector<T> *data, uint64_t value, uint64_t length){
-    insertString(data, eosio::name(value).to_string(), length);
-  }
-
-  template <typename T>
-  static inline void insertName(std::vector<T> *data, eosio::name value, uint64_t length){
-    insertString(data, value.to_string(), length);
-  }
 
   /**
    * Keccak (SHA3) Functions
@@ -232,10 +186,7 @@ namespace evm_bridge
     unsigned char* output)
   {
     // Ethereum started using Keccak and called it SHA3 before it was finalised.
-    SHA3_CTX context;
-    keccak_init(&context);
-    keccak_update(&context, input, inputByteLen);
-    keccak_final(&context, output);
+    keccak::hash(input, inputByteLen, output);
   }
 
   using KeccakHash = std::array<uint8_t, 32u>;
@@ -311,4 +262,110 @@ namespace evm_bridge
     // Return as address
     return intx::be::load<uint256_t>(right_160);
   };
+
+  /**
+   * Mapping slots
+   */
+  // Slot of a Solidity mapping value: keccak256(key . slot) with value type keys as 32 byte words
+  // Nested mappings take the slot of the outer value: getMappingSlot(key2, getMappingSlot(key1, slot))
+  inline uint256_t getMappingSlot(const uint256_t& key, const uint256_t& mapping_slot){
+    std::array<uint8_t, 64u> preimage;
+    intx::be::unsafe::store(preimage.data(), key);
+    intx::be::unsafe::store(preimage.data() + 32, mapping_slot);
+    return bytesToValue(keccak_256(preimage));
+  }
+
+  // Address keys, left padded to a word
+  inline uint256_t getMappingSlot(const eosio::checksum160& key, const uint256_t& mapping_slot){
+    return getMappingSlot(checksum160ToAddress(key), mapping_slot);
+  }
+
+  // String & bytes keys are hashed unpadded: keccak256(bytes(key) . slot)
+  inline uint256_t getMappingSlot(std::string_view key, const uint256_t& mapping_slot){
+    std::vector<uint8_t> preimage;
+    preimage.reserve(key.size() + 32);
+    preimage.insert(preimage.end(), key.begin(), key.end());
+    preimage.resize(key.size() + 32);
+    intx::be::unsafe::store(preimage.data() + key.size(), mapping_slot);
+    return bytesToValue(keccak_256(preimage));
+  }
+
+  // Member `position` of a struct held by a mapping
+  template <typename K>
+  inline const eosio::checksum256 getMappingMemberSlot(const K& key, const uint256_t& mapping_slot, uint256_t position){
+    return toChecksum256(getMappingSlot(key, mapping_slot) + position);
+  }
+
+  /**
+   * Storage reads
+   */
+  // Reads a word from an Account States bykey index, zero words have no row at all
+  template <typename T>
+  inline uint256_t readWordFromStorage(T& states_bykey, const eosio::checksum256& slot_key){
+    const auto row = states_bykey.find(slot_key);
+    return (row != states_bykey.end()) ? uint256_t(row->value) : uint256_t(0);
+  }
+
+  // Reads ascending slots of an Account States bykey index (the members of a struct, a run of array elements) off a
+  // single lower_bound: keys order like the slot numbers, so the row of the next slot is at most a few rows further.
+  // Zero words have no row, a slot whose row is missing reads as zero & leaves the cursor where it is. Going back or
+  // jumping more than MAX_STORAGE_RANGE_STEP slots ahead seeks again. Has the find / end interface of the index it wraps
+  template <typename T>
+  class storage_range {
+    public:
+      using const_iterator = decltype(std::declval<const T&>().end());
+
+      explicit storage_range(T& states_bykey) : states_bykey(states_bykey), row(states_bykey.end()) {}
+
+      // Row of `slot_key`, or end() for a zero word
+      const_iterator find(const eosio::checksum256& slot_key){
+        const uint256_t slot = checksum256ToValue(slot_key);
+        if(!positioned || slot < last_slot || slot - last_slot > MAX_STORAGE_RANGE_STEP){
+          row = states_bykey.lower_bound(slot_key);
+          positioned = true;
+        } else {
+          while(row != states_bykey.end() && row->by_key() < slot_key) ++row;
+        }
+        last_slot = slot;
+        return (row != states_bykey.end() && row->by_key() == slot_key) ? row : states_bykey.end();
+      }
+
+      const_iterator require_find(const eosio::checksum256& slot_key, const char* error_msg){
+        const auto found = find(slot_key);
+        eosio::check(found != states_bykey.end(), error_msg);
+        return found;
+      }
+
+      const_iterator end() const { return states_bykey.end(); }
+
+    private:
+      T& states_bykey;
+      const_iterator row;
+      uint256_t last_slot = 0;
+      bool positioned = false;
+  };
+
+  // Reads a Solidity string of any length from an Account States bykey index, keeping its first MAX_STORAGE_STRING_LENGTH bytes
+  // Long strings (>= 32 bytes) keep length * 2 + 1 in their slot and their bytes from keccak256(slot) onwards
+  template <typename T>
+  inline std::string readStringFromStorage(T& states_bykey, const eosio::checksum256& slot_key){
+    const uint256_t word = readWordFromStorage(states_bykey, slot_key);
+    std::array<uint8_t, 32u> buffer;
+    intx::be::unsafe::store(buffer.data(), word);
+    if((buffer[31] & 1) == 0){
+      return std::string(reinterpret_cast<const char*>(buffer.data()), buffer[31] / 2);
+    }
+
+    // Anyone can register a token with a long name, truncate it rather than failing every read of its pair
+    const size_t length = (word > uint256_t(MAX_STORAGE_STRING_LENGTH * 2 + 1)) ? MAX_STORAGE_STRING_LENGTH : static_cast<size_t>((word - 1) / 2);
+    std::string result(length, '\0');
+    const uint256_t data_slot = bytesToValue(keccak_256(slot_key.extract_as_byte_array()));
+    for(size_t offset = 0; offset < length; offset += WORD_SIZE){
+      const auto data_row = states_bykey.find(toChecksum256(data_slot + offset / WORD_SIZE));
+      if(data_row == states_bykey.end()) continue; // zero word, already zero filled
+      intx::be::unsafe::store(buffer.data(), data_row->value);
+      memcpy(&result[offset], buffer.data(), std::min<size_t>(WORD_SIZE, length - offset));
+    }
+    return result;
+  }
 } // namespace bridge_evm
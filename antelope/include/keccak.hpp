@@ -0,0 +1,132 @@
+#pragma once
+
+#if (KECCAK_HOST_FUNCTION == true)
+#include <eosio/crypto_ext.hpp>
+#endif
+
+namespace evm_bridge
+{
+  /**
+   * Runtime Keccak-256 backends, the one behind keccak_256 is picked at build time with KECCAK_HOST_FUNCTION
+   */
+  namespace keccak
+  {
+    // Keccak-f[1600] with theta, rho & pi unrolled, no lookup tables nor modulos
+    inline void permuteUnrolled(uint64_t a[25])
+    {
+      for (size_t round = 0; round < 24; round++) {
+        // Theta
+        const uint64_t c0 = a[0] ^ a[5] ^ a[10] ^ a[15] ^ a[20];
+        const uint64_t c1 = a[1] ^ a[6] ^ a[11] ^ a[16] ^ a[21];
+        const uint64_t c2 = a[2] ^ a[7] ^ a[12] ^ a[17] ^ a[22];
+        const uint64_t c3 = a[3] ^ a[8] ^ a[13] ^ a[18] ^ a[23];
+        const uint64_t c4 = a[4] ^ a[9] ^ a[14] ^ a[19] ^ a[24];
+        const uint64_t d0 = c4 ^ rotl(c1, 1);
+        const uint64_t d1 = c0 ^ rotl(c2, 1);
+        const uint64_t d2 = c1 ^ rotl(c3, 1);
+        const uint64_t d3 = c2 ^ rotl(c4, 1);
+        const uint64_t d4 = c3 ^ rotl(c0, 1);
+        // Rho & Pi
+        const uint64_t b00 = a[0] ^ d0;
+        const uint64_t b01 = rotl(a[6] ^ d1, 44);
+        const uint64_t b02 = rotl(a[12] ^ d2, 43);
+        const uint64_t b03 = rotl(a[18] ^ d3, 21);
+        const uint64_t b04 = rotl(a[24] ^ d4, 14);
+        const uint64_t b05 = rotl(a[3] ^ d3, 28);
+        const uint64_t b06 = rotl(a[9] ^ d4, 20);
+        const uint64_t b07 = rotl(a[10] ^ d0, 3);
+        const uint64_t b08 = rotl(a[16] ^ d1, 45);
+        const uint64_t b09 = rotl(a[22] ^ d2, 61);
+        const uint64_t b10 = rotl(a[1] ^ d1, 1);
+        const uint64_t b11 = rotl(a[7] ^ d2, 6);
+        const uint64_t b12 = rotl(a[13] ^ d3, 25);
+        const uint64_t b13 = rotl(a[19] ^ d4, 8);
+        const uint64_t b14 = rotl(a[20] ^ d0, 18);
+        const uint64_t b15 = rotl(a[4] ^ d4, 27);
+        const uint64_t b16 = rotl(a[5] ^ d0, 36);
+        const uint64_t b17 = rotl(a[11] ^ d1, 10);
+        const uint64_t b18 = rotl(a[17] ^ d2, 15);
+        const uint64_t b19 = rotl(a[23] ^ d3, 56);
+        const uint64_t b20 = rotl(a[2] ^ d2, 62);
+        const uint64_t b21 = rotl(a[8] ^ d3, 55);
+        const uint64_t b22 = rotl(a[14] ^ d4, 39);
+        const uint64_t b23 = rotl(a[15] ^ d0, 41);
+        const uint64_t b24 = rotl(a[21] ^ d1, 2);
+        // Chi
+        a[0] = b00 ^ (~b01 & b02);
+        a[1] = b01 ^ (~b02 & b03);
+        a[2] = b02 ^ (~b03 & b04);
+        a[3] = b03 ^ (~b04 & b00);
+        a[4] = b04 ^ (~b00 & b01);
+        a[5] = b05 ^ (~b06 & b07);
+        a[6] = b06 ^ (~b07 & b08);
+        a[7] = b07 ^ (~b08 & b09);
+        a[8] = b08 ^ (~b09 & b05);
+        a[9] = b09 ^ (~b05 & b06);
+        a[10] = b10 ^ (~b11 & b12);
+        a[11] = b11 ^ (~b12 & b13);
+        a[12] = b12 ^ (~b13 & b14);
+        a[13] = b13 ^ (~b14 & b10);
+        a[14] = b14 ^ (~b10 & b11);
+        a[15] = b15 ^ (~b16 & b17);
+        a[16] = b16 ^ (~b17 & b18);
+        a[17] = b17 ^ (~b18 & b19);
+        a[18] = b18 ^ (~b19 & b15);
+        a[19] = b19 ^ (~b15 & b16);
+        a[20] = b20 ^ (~b21 & b22);
+        a[21] = b21 ^ (~b22 & b23);
+        a[22] = b22 ^ (~b23 & b24);
+        a[23] = b23 ^ (~b24 & b20);
+        a[24] = b24 ^ (~b20 & b21);
+        // Iota
+        a[0] ^= ROUND_CONSTANTS[round];
+      }
+    }
+
+    inline uint64_t loadLE64(const uint8_t* p)
+    {
+      return uint64_t(p[0]) | (uint64_t(p[1]) << 8) | (uint64_t(p[2]) << 16) | (uint64_t(p[3]) << 24)
+        | (uint64_t(p[4]) << 32) | (uint64_t(p[5]) << 40) | (uint64_t(p[6]) << 48) | (uint64_t(p[7]) << 56);
+    }
+
+    // In contract implementation, works on every chain
+    inline void hashPortable(const uint8_t* input, size_t length, uint8_t* output)
+    {
+      uint64_t state[25] = {};
+
+      // Absorb every full block a lane at a time
+      for (; length >= RATE; input += RATE, length -= RATE) {
+        for (size_t i = 0; i < RATE / 8; i++) {
+          state[i] ^= loadLE64(input + 8 * i);
+        }
+        permuteUnrolled(state);
+      }
+
+      // Pad & absorb the last block
+      uint8_t last[RATE] = {};
+      memcpy(last, input, length);
+      last[length] = 0x01;
+      last[RATE - 1] |= 0x80;
+      for (size_t i = 0; i < RATE / 8; i++) {
+        state[i] ^= loadLE64(last + 8 * i);
+      }
+      permuteUnrolled(state);
+
+      // Squeeze 256 bits
+      for (size_t i = 0; i < 32; i++) {
+        output[i] = uint8_t(state[i / 8] >> (8 * (i % 8)));
+      }
+    }
+
+    inline void hash(const uint8_t* input, size_t length, uint8_t* output)
+    {
+    #if (KECCAK_HOST_FUNCTION == true)
+      // Crypto extension host function (requires the CRYPTO_PRIMITIVES protocol feature)
+      const auto digest = eosio::keccak(reinterpret_cast<const char*>(input), length).extract_as_byte_array();
+      memcpy(output, digest.data(), digest.size());
+    #else
+      hashPortable(input, length, output);
+    #endif
+    }
+  } // namespace keccak
+} // namespace evm_bridge
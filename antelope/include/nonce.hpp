@@ -0,0 +1,40 @@
+#pragma once
+
+namespace evm_bridge {
+    //======================== EVM nonces ========================
+    // Hands out consecutive nonces to the raw calls of this contract's EVM account. Inline raw calls only run once the
+    // actions queued before them have, so a deposit notified right after another one would read the same account nonce:
+    // the nonces handed out are kept in the `nonces` singleton & the next action continues after them. A transaction
+    // failing reverts its reservations with it, so the account nonce always catches up
+    class nonce_allocator {
+        public:
+            nonce_allocator(eosio::name self) : self(self), table(self, self.value) {
+                account_table accounts(EVM_SYSTEM_CONTRACT, EVM_SYSTEM_CONTRACT.value);
+                auto accounts_byaccount = accounts.get_index<"byaccount"_n>();
+                const auto account = accounts_byaccount.require_find(self.value, "EVM account not found for token.brdg");
+                address = account->address;
+                next = std::max(account->nonce, table.get_or_default().next);
+            };
+
+            // Reserves the next nonce, only once a call is sure to be sent so skipped items leave no gap
+            uint64_t reserve() {
+                reserved++;
+                return next++;
+            }
+
+            // Writes the nonces handed out back, once per action
+            void save() {
+                if(reserved > 0){
+                    table.set(nonces { next }, self);
+                }
+            }
+
+            eosio::checksum160 address;
+
+        private:
+            eosio::name self;
+            nonces_singleton table;
+            uint64_t next;
+            uint64_t reserved = 0;
+    };
+}
@@ -0,0 +1,270 @@
+#pragma once
+
+namespace evm_bridge {
+    //======================== Token symbols ========================
+    // eosio.token stat lookups, memoized per token for the length of an action
+    class token_symbols {
+        public:
+            // The token's symbol with its Antelope precision, from its stat table (and not the EVM Register, in case the token issuer changes precision)
+            eosio::symbol get(eosio::name token_contract, eosio::symbol_code code) {
+                const std::optional<eosio::symbol> symbol = find(token_contract, code);
+                check(symbol.has_value(), "Token not found. Make sure the symbol is correct.");
+                return *symbol;
+            }
+
+            // Same as get, none when the token contract has no such symbol
+            std::optional<eosio::symbol> find(eosio::name token_contract, eosio::symbol_code code) {
+                for(const auto& token : tokens){
+                    if(token.contract == token_contract && token.symbol.code() == code){
+                        return token.symbol;
+                    }
+                }
+                eosio_tokens token_row(token_contract, code.raw());
+                const auto antelope_token = token_row.find(code.raw());
+                if(antelope_token == token_row.end()){
+                    return std::nullopt;
+                }
+                tokens.push_back(token { token_contract, antelope_token->supply.symbol });
+                return antelope_token->supply.symbol;
+            }
+
+        private:
+            struct token {
+                eosio::name contract;
+                eosio::symbol symbol;
+            };
+
+            std::vector<token> tokens;
+    };
+
+    //======================== Shards ========================
+    // The part of the notify queues a crank pays out: the ids of the dedupe partitions equal to `id` modulo `count`, so
+    // cranks of different shards never pay the same items nor write the same dedupe rows. The partitions do not depend
+    // on the shard count, so cranks may change it from one call to the next without paying an id twice
+    struct notify_shard {
+        uint64_t id = 0;
+        uint64_t count = 1;
+
+        // Checks the shard spec passed to a notify action
+        static notify_shard of(uint64_t id, uint64_t count) {
+            check(count > 0 && NOTIFY_PARTITIONS % count == 0, "Shard count must divide " + std::to_string(NOTIFY_PARTITIONS));
+            check(id < count, "Shard id must be below the shard count");
+            return notify_shard { id, count };
+        }
+
+        bool sharded() const { return count > 1; }
+        bool ownsPartition(uint64_t partition) const { return partition % count == id; }
+        bool owns(uint64_t item_id) const { return ownsPartition(dedupe::partitionOf(item_id)); }
+
+        uint64_t key() const { return (count << 32) | id; }
+    };
+
+    //======================== Dedupe windows ========================
+    // The processed ids of a notify queue, whatever the shard paid them, & the pass of `shard` over its EVM array
+    // Each partition is loaded on first use & written back only when it changed
+    class dedupe_window {
+        public:
+            dedupe_window(eosio::name self, eosio::name queue, const notify_shard& shard)
+                : self(self), queue(queue), shard(shard), table(self, queue.value), scans(self, queue.value) {};
+
+            // Recorded in its partition, or paid out by the contract before the dedupe rows existed
+            bool contains(uint64_t id) { return partition(id).row.contains(dedupe::rankOf(id)) || legacyContains(id); }
+
+            // Under the watermark of its partition
+            bool below(uint64_t id) { return dedupe::rankOf(id) < partition(id).row.watermark; }
+
+            // Past the window of its partition, it cannot be recorded until the watermark catches up
+            bool fits(uint64_t id) { return partition(id).row.fits(dedupe::rankOf(id)); }
+
+            // Records an id, false when it is past the window
+            bool insert(uint64_t id) {
+                partition_state& state = partition(id);
+                const uint64_t rank = dedupe::rankOf(id);
+                if(state.row.contains(rank)){
+                    return true;
+                }
+                const bool recorded = state.row.insert(rank);
+                state.changed |= recorded;
+                return recorded;
+            }
+
+            // Moves the watermarks of the partitions loaded past the ids processed right above them
+            void advance() {
+                for(auto& state : partitions){
+                    if(state.loaded){
+                        const uint64_t watermark = state.row.watermark;
+                        state.row.advance();
+                        state.changed |= state.row.watermark != watermark;
+                    }
+                }
+            }
+
+            // Every id of the shard below `next` has been processed or is gone from EVM
+            void moveTo(uint64_t next) {
+                for(uint64_t p = 0; p < NOTIFY_PARTITIONS; p++){
+                    if(shard.ownsPartition(p)){
+                        partition_state& state = load(p);
+                        const uint64_t watermark = state.row.watermark;
+                        state.row.moveTo(state.row.rankFrom(next));
+                        state.changed |= state.row.watermark != watermark;
+                    }
+                }
+            }
+
+            // The shard's pass over the EVM array, written back when it changed
+            notifyscan& scan() {
+                if(!scan_loaded){
+                    scan_loaded = true;
+                    const auto itr = scans.find(shard.key());
+                    scan_stored = itr != scans.end();
+                    stored_scan = scan_stored ? *itr : notifyscan { shard.key() };
+                    current_scan = stored_scan;
+                }
+                return current_scan;
+            }
+
+            void save() {
+                for(const auto& state : partitions){
+                    if(!state.changed){
+                        continue;
+                    }
+                    const auto upsert = [&](auto& d) { d = state.row; };
+                    if(state.stored){
+                        table.modify(table.find(state.row.partition), self, upsert);
+                    } else {
+                        table.emplace(self, upsert);
+                    }
+                }
+                if(scan_loaded && (current_scan.cursor != stored_scan.cursor || current_scan.pass_end != stored_scan.pass_end || current_scan.floor != stored_scan.floor)){
+                    const auto upsert = [&](auto& s) { s = current_scan; };
+                    if(scan_stored){
+                        scans.modify(scans.find(current_scan.shard), self, upsert);
+                    } else {
+                        scans.emplace(self, upsert);
+                    }
+                }
+            }
+
+        private:
+            struct partition_state {
+                dedupe row;
+                bool loaded = false;
+                bool stored = false;
+                bool changed = false;
+            };
+
+            partition_state& partition(uint64_t id) { return load(dedupe::partitionOf(id)); }
+
+            // A missing partition starts at watermark 0, the first pass over the array moves it up to the ids still there
+            partition_state& load(uint64_t p) {
+                partition_state& state = partitions[p];
+                if(state.loaded){
+                    return state;
+                }
+                state.loaded = true;
+                const auto itr = table.find(p);
+                state.stored = itr != table.end();
+                state.row = state.stored ? *itr : dedupe { p };
+                return state;
+            }
+
+            // Looks the id up in the legacy rows while there are any, one emptiness check per action once they are gone
+            bool legacyContains(uint64_t id) {
+                if(legacy_empty){
+                    return false;
+                }
+                if(queue == "requests"_n){
+                    requests_table requests(self, self.value);
+                    return legacyFind(requests, id);
+                }
+                refunds_table refunds(self, self.value);
+                return legacyFind(refunds, id);
+            }
+
+            template <typename T>
+            bool legacyFind(T& legacy, uint64_t id) {
+                if(!legacy_checked){
+                    legacy_checked = true;
+                    legacy_empty = legacy.begin() == legacy.end();
+                    if(legacy_empty){
+                        return false;
+                    }
+                }
+                auto by_call_id = legacy.template get_index<"callid"_n>();
+                return by_call_id.find(toChecksum256(uint256_t(id))) != by_call_id.end();
+            }
+
+            eosio::name self;
+            eosio::name queue;
+            notify_shard shard;
+            dedupe_table table;
+            notify_scans_table scans;
+            std::array<partition_state, NOTIFY_PARTITIONS> partitions;
+            notifyscan stored_scan;
+            notifyscan current_scan;
+            bool scan_loaded = false;
+            bool scan_stored = false;
+            bool legacy_checked = false;
+            bool legacy_empty = false;
+    };
+
+    //======================== Notify context ========================
+    // What the notify actions look up once per transaction: configs & settings, this contract's EVM account, the TokenBridge
+    // storage, the dedupe windows, token symbols & the metrics, shared by the requests & refunds passes of `process`
+    class notify_context {
+        public:
+            notify_context(eosio::name self, const bridgeconfig& conf, const config& evm_conf, const notify_shard& shard)
+                : self(self), conf(conf), tuning(settings_singleton(self, self.value).get_or_default()), shard(shard), gas_price(evm_conf.gas_price),
+                  bridge_states(EVM_SYSTEM_CONTRACT, conf.evm_bridge_scope),
+                  requests_dedupe(self, "requests"_n, shard), refunds_dedupe(self, "refunds"_n, shard),
+                  budget(tuning.notify_max_items, tuning.notify_max_cost), recorder(self, shard.sharded() ? shard.key() : 0),
+                  nonces(self), address(nonces.address) {};
+
+            // Length of a TokenBridge array, a missing row is an empty array unless `missing_message` is set
+            uint64_t arrayLength(uint8_t storage_index, const char* missing_message = nullptr) {
+                auto bridge_states_bykey = bridge_states.get_index<"bykey"_n>();
+                const auto length = bridge_states_bykey.find(toChecksum256(storage_index));
+                lengths_read++;
+                if(missing_message){
+                    check(length != bridge_states_bykey.end(), missing_message);
+                }
+                return length != bridge_states_bykey.end() ? static_cast<uint64_t>(length->value) : 0;
+            }
+
+            // Next id of a TokenBridge id counter, a uint stored at its slot like an array length
+            uint64_t nextId(uint8_t storage_index) {
+                return arrayLength(storage_index);
+            }
+
+            // Signs the next raw transaction of this contract's EVM account, nonces follow each other across both passes
+            std::vector<int8_t> encodeCall(uint64_t gas, const std::vector<uint8_t>& data) {
+                return encodeTransaction(nonces.reserve(), gas_price, gas, conf.evm_bridge_address, uint256_t(0), data, CURRENT_CHAIN_ID);
+            }
+
+            // Saves the dedupe windows & metrics once for every pass
+            void save() {
+                requests_dedupe.save();
+                refunds_dedupe.save();
+                nonces.save();
+                recorder.delta.slots_read = budget.slots_read + lengths_read;
+                recorder.delta.inline_actions = budget.inline_actions;
+                recorder.delta.notify_calls = 1;
+                recorder.save();
+            }
+
+            eosio::name self;
+            bridgeconfig conf;
+            settings tuning;
+            notify_shard shard;
+            uint256_t gas_price;
+            account_state_table bridge_states;
+            dedupe_window requests_dedupe;
+            dedupe_window refunds_dedupe;
+            token_symbols symbols;
+            notify_budget budget;
+            stats_recorder recorder;
+            nonce_allocator nonces;
+            eosio::checksum160 address;
+            uint64_t lengths_read = 0;
+    };
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+namespace evm_bridge {
+    //======================== Read only query results ========================
+    // A TokenBridge request waiting to be paid out on Antelope
+    struct pending_request {
+        uint64_t index;                 // position in the TokenBridge requests[] array
+        uint64_t call_id;
+        eosio::checksum160 sender;
+        eosio::name token_contract;
+        eosio::asset quantity;
+        eosio::name receiver;
+
+        EOSLIB_SERIALIZE(pending_request, (index)(call_id)(sender)(token_contract)(quantity)(receiver));
+    };
+
+    // A TokenBridge refund waiting to be paid back on Antelope
+    struct pending_refund {
+        uint64_t index;                 // position in the TokenBridge refunds[] array
+        uint64_t refund_id;
+        eosio::name token_contract;
+        eosio::asset quantity;
+        eosio::name receiver;
+        bool resolved = true;           // false when the token has no such symbol on Antelope (empty quantity), the refund is then settled without a transfer
+
+        EOSLIB_SERIALIZE(pending_refund, (index)(refund_id)(token_contract)(quantity)(receiver)(resolved));
+    };
+
+    // A PairBridgeRegister pair, as stored on EVM
+    struct evm_pair {
+        uint64_t index;                 // position in the PairBridgeRegister pairs[] array
+        uint64_t id;
+        bool active;
+        eosio::checksum160 evm_address;
+        uint8_t evm_decimals;
+        uint8_t antelope_decimals;
+        eosio::name issuer;
+        eosio::name account;
+        eosio::symbol_code symbol;
+        std::string evm_symbol;
+        std::string evm_name;
+
+        EOSLIB_SERIALIZE(evm_pair, (index)(id)(active)(evm_address)(evm_decimals)(antelope_decimals)(issuer)(account)(symbol)(evm_symbol)(evm_name));
+    };
+
+    // Pages of EVM arrays, `next` is the offset of the following page and equals `total` on the last one
+    struct pending_requests {
+        std::vector<pending_request> items;
+        uint64_t next;
+        uint64_t total;
+
+        EOSLIB_SERIALIZE(pending_requests, (items)(next)(total));
+    };
+
+    struct pending_refunds {
+        std::vector<pending_refund> items;
+        uint64_t next;
+        uint64_t total;
+
+        EOSLIB_SERIALIZE(pending_refunds, (items)(next)(total));
+    };
+
+    struct evm_pairs {
+        std::vector<evm_pair> items;
+        uint64_t next;
+        uint64_t total;
+
+        EOSLIB_SERIALIZE(evm_pairs, (items)(next)(total));
+    };
+
+    // What the next reqnotify would do: its result & the requests it would pay out
+    struct notify_preview {
+        notify_result result;
+        std::vector<pending_request> items;
+
+        EOSLIB_SERIALIZE(notify_preview, (result)(items));
+    };
+}
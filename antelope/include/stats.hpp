@@ -0,0 +1,105 @@
+#pragma once
+
+namespace evm_bridge {
+    //======================== Stats ========================
+    // Accumulates the metrics of one action in memory, then adds them to the stats singleton with a single row write
+    // (plus one tokenstats row write per token the action moved). A sharded notify crank writes its shard's shardstats row
+    // instead, so parallel shards never write the same row, and bridge() folds its counts into its token's row
+    class stats_recorder {
+        public:
+            // `shard` is the key of the crank's shard, 0 when it is not sharded
+            stats_recorder(eosio::name self, uint64_t shard = 0) : self(self), shard(shard) {};
+
+            // Counts one bridged / processed / refunded transfer of a token
+            void add_token(eosio::name token_contract, const eosio::asset& quantity, uint64_t tokenstats::* count, int64_t tokenstats::* amount) {
+                for(auto& token : tokens){
+                    if(token.contract == token_contract && token.row.symbol == quantity.symbol){
+                        token.row.*count += 1;
+                        token.row.*amount += quantity.amount;
+                        return;
+                    }
+                }
+                token_delta token { token_contract, tokenstats { quantity.symbol } };
+                token.row.*count += 1;
+                token.row.*amount += quantity.amount;
+                tokens.push_back(token);
+            }
+
+            void save() {
+                if(shard != 0){
+                    saveShard();
+                    return;
+                }
+                stats_singleton stats_table(self, self.value);
+                auto totals = stats_table.get_or_default();
+                totals.add(delta);
+                totals.last_update = current_time_point();
+                stats_table.set(totals, self);
+                saveTokens();
+            }
+
+            // Saves the metrics of an action that moved a single token with that token's row write only
+            void saveToToken() {
+                check(shard == 0 && tokens.size() == 1, "Only the metrics of a single token fold into its row");
+                auto& row = tokens.front().row;
+                row.slots_read += delta.slots_read;
+                row.inline_actions += delta.inline_actions;
+                row.batches_sent += delta.batches_sent;
+                row.deposits_returned += delta.deposits_returned;
+                saveTokens();
+            }
+
+            stats delta;
+
+        private:
+            struct token_delta {
+                eosio::name contract;
+                tokenstats row;
+            };
+
+            void saveTokens() {
+                for(const auto& token : tokens){
+                    tokenstats_table tokens_table(self, token.contract.value);
+                    const auto upsert = [&](auto& t) {
+                        t.symbol = token.row.symbol;
+                        t.add(token.row);
+                    };
+                    const auto existing = tokens_table.find(token.row.primary_key());
+                    if(existing == tokens_table.end()){
+                        tokens_table.emplace(self, upsert);
+                    } else {
+                        tokens_table.modify(existing, self, upsert);
+                    }
+                }
+            }
+
+            void saveShard() {
+                shardstats_table shards(self, self.value);
+                const auto upsert = [&](auto& s) {
+                    s.shard = shard;
+                    s.totals.add(delta);
+                    s.totals.last_update = current_time_point();
+                    for(const auto& token : tokens){
+                        auto existing = std::find_if(s.tokens.begin(), s.tokens.end(), [&](const shardtoken& t) {
+                            return t.contract == token.contract && t.totals.symbol == token.row.symbol;
+                        });
+                        if(existing == s.tokens.end()){
+                            s.tokens.push_back(shardtoken { token.contract, tokenstats { token.row.symbol } });
+                            existing = s.tokens.end() - 1;
+                        }
+                        existing->totals.add(token.row);
+                    }
+                };
+                const auto existing = shards.find(shard);
+                if(existing == shards.end()){
+                    shards.emplace(self, upsert);
+                } else {
+                    shards.modify(existing, self, upsert);
+                }
+            }
+
+            eosio::name self;
+            uint64_t shard;
+            std::vector<token_delta> tokens;
+    };
+}
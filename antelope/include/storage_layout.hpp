@@ -0,0 +1,171 @@
+#pragma once
+
+namespace evm_bridge
+{
+  /**
+   * Solidity struct layouts
+   */
+  // Types of the struct members read from EVM Storage
+  enum class sol_type : uint8_t { boolean, uint8, address, uint256, string };
+
+  // Bytes a member takes in its slot, 0 for strings which always take whole slots of their own
+  constexpr uint8_t solidityBytes(sol_type type)
+  {
+    switch (type) {
+      case sol_type::boolean: return 1;
+      case sol_type::uint8: return 1;
+      case sol_type::address: return 20;
+      case sol_type::uint256: return 32;
+      default: return 0;
+    }
+  }
+
+  // Where a member lives: its slot from the struct start & its byte offset from the right of that slot
+  struct sol_member {
+    uint8_t slot = 0;
+    uint8_t offset = 0;
+    uint8_t bytes = 0;
+  };
+
+  // Lays members out like solc does: a member packs after the previous one if it fits in the rest of its slot,
+  // else it starts the next slot. Strings start a new slot, and so does the member after them
+  template <size_t N>
+  constexpr std::array<sol_member, N> layoutMembers(const std::array<sol_type, N>& types)
+  {
+    std::array<sol_member, N> members = {};
+    uint8_t slot = 0;
+    uint8_t used = 0;
+    for (size_t m = 0; m < N; m++) {
+      const uint8_t bytes = solidityBytes(types[m]);
+      if (used > 0 && (bytes == 0 || used + bytes > WORD_SIZE)) {
+        slot++;
+        used = 0;
+      }
+      members[m] = sol_member { slot, used, bytes };
+      used = (bytes == 0) ? WORD_SIZE : used + bytes;
+    }
+    return members;
+  }
+
+  // A Solidity struct, from the types of its members in declaration order
+  template <sol_type... Types>
+  struct sol_struct {
+    static constexpr size_t member_count = sizeof...(Types);
+    static constexpr std::array<sol_type, member_count> types = { Types... };
+    static constexpr std::array<sol_member, member_count> members = layoutMembers(types);
+    static constexpr uint8_t slot_count = members[member_count - 1].slot + 1;
+  };
+
+  // Packing rules: small members share a slot until the next one does not fit, uint256 & strings always start one
+  static_assert(sol_struct<sol_type::boolean, sol_type::uint8, sol_type::address, sol_type::uint8, sol_type::uint256>::members[3].offset == 22);
+  static_assert(sol_struct<sol_type::address, sol_type::address, sol_type::string, sol_type::uint8>::members[1].slot == 1);
+  static_assert(sol_struct<sol_type::uint8, sol_type::string, sol_type::uint8, sol_type::uint8>::slot_count == 3);
+
+  // Each layout mirrors a struct of the .sol contracts: the member enum lists its members in the same order as the
+  // types, & the static_asserts pin the slots token.brdg relies on so a reordered struct fails to compile
+  // TokenBridge Request
+  struct request_layout : sol_struct<sol_type::uint256, sol_type::address, sol_type::uint256, sol_type::uint256,
+      sol_type::string, sol_type::string, sol_type::string, sol_type::uint8> {
+    enum member : uint8_t { id, sender, amount, requested_at, antelope_token, antelope_symbol, receiver, evm_decimals, member_end };
+  };
+  static_assert(request_layout::member_end == request_layout::member_count, "Request members and types differ");
+  static_assert(request_layout::slot_count == 8 && request_layout::members[request_layout::evm_decimals].slot == 7);
+
+  // TokenBridge Refund
+  struct refund_layout : sol_struct<sol_type::uint256, sol_type::uint256, sol_type::string, sol_type::string,
+      sol_type::string, sol_type::uint8> {
+    enum member : uint8_t { id, amount, antelope_token, antelope_symbol, receiver, evm_decimals, member_end };
+  };
+  static_assert(refund_layout::member_end == refund_layout::member_count, "Refund members and types differ");
+  static_assert(refund_layout::slot_count == 6 && refund_layout::members[refund_layout::evm_decimals].slot == 5);
+
+  // PairBridgeRegister Pair, decimals are uint256 there as a packed uint8 would share the address slot
+  struct pair_layout : sol_struct<sol_type::boolean, sol_type::uint256, sol_type::address, sol_type::uint256,
+      sol_type::uint256, sol_type::string, sol_type::string, sol_type::string, sol_type::string, sol_type::string> {
+    enum member : uint8_t { active, id, evm_address, evm_decimals, antelope_decimals, antelope_issuer_name,
+      antelope_account_name, antelope_symbol_name, evm_symbol, evm_name, member_end };
+  };
+  static_assert(pair_layout::member_end == pair_layout::member_count, "Pair members and types differ");
+  static_assert(pair_layout::slot_count == 10 && pair_layout::members[pair_layout::id].slot == 1);
+
+  // PairBridgeRegister Request
+  struct registration_layout : sol_struct<sol_type::uint256, sol_type::address, sol_type::address, sol_type::uint256,
+      sol_type::uint256, sol_type::uint256, sol_type::string, sol_type::string, sol_type::string, sol_type::string,
+      sol_type::string> {
+    enum member : uint8_t { id, sender, evm_address, evm_decimals, timestamp, antelope_decimals, antelope_issuer_name,
+      antelope_account_name, antelope_symbol_name, evm_symbol, evm_name, member_end };
+  };
+  static_assert(registration_layout::member_end == registration_layout::member_count, "Registration request members and types differ");
+  static_assert(registration_layout::slot_count == 11 && registration_layout::members[registration_layout::evm_address].slot == 2);
+
+  // Slot of a struct member at `i` of the dynamic array starting at `array_slot`
+  template <typename Layout>
+  inline const eosio::checksum256 getStructMemberSlot(const uint256_t& array_slot, uint8_t member, uint64_t i)
+  {
+    return getArrayMemberSlot(array_slot, Layout::members[member].slot, Layout::slot_count, i);
+  }
+
+  /**
+   * Lazy struct reads
+   */
+  // A struct at `i` of an EVM Storage array, nothing is read until a member is
+  template <typename Layout, typename T>
+  struct storage_struct {
+    T& states_bykey;
+    uint256_t array_slot;
+    uint64_t i;
+
+    eosio::checksum256 slot(uint8_t member) const { return getStructMemberSlot<Layout>(array_slot, member, i); }
+  };
+
+  template <typename Layout, typename T>
+  inline storage_struct<Layout, T> storageStruct(T& states_bykey, const std::array<uint8_t, 32u>& array_slot, uint64_t i)
+  {
+    return storage_struct<Layout, T> { states_bykey, bytesToValue(array_slot), i };
+  }
+
+  // Bytes of a member out of its slot word, strings keep the whole word
+  template <typename Layout>
+  inline uint256_t extractMember(const uint256_t& word, uint8_t member)
+  {
+    const sol_member& layout = Layout::members[member];
+    if (layout.bytes == 0 || layout.bytes == WORD_SIZE) return word;
+    return (word >> (8 * layout.offset)) & ((uint256_t(1) << (8 * layout.bytes)) - 1);
+  }
+
+  // Member value typed after its Solidity type, short strings stay a word to decode in place
+  template <sol_type Type>
+  inline auto decodeMember(const uint256_t& value)
+  {
+    if constexpr (Type == sol_type::boolean) return value != 0;
+    else if constexpr (Type == sol_type::uint8) return static_cast<uint8_t>(value);
+    else if constexpr (Type == sol_type::address) return addressToChecksum160(value);
+    else return value;
+  }
+
+  // Reads one member, a missing row is a zero member
+  template <auto Member, typename Layout, typename T>
+  inline auto readMember(const storage_struct<Layout, T>& s)
+  {
+    static_assert(Member < Layout::member_count, "No such struct member");
+    const uint256_t word = readWordFromStorage(s.states_bykey, s.slot(Member));
+    return decodeMember<Layout::types[Member]>(extractMember<Layout>(word, Member));
+  }
+
+  // Reads one member whose row must exist
+  template <auto Member, typename Layout, typename T>
+  inline auto requireMember(const storage_struct<Layout, T>& s, const char* missing_message)
+  {
+    static_assert(Member < Layout::member_count, "No such struct member");
+    const auto row = s.states_bykey.require_find(s.slot(Member), missing_message);
+    return decodeMember<Layout::types[Member]>(extractMember<Layout>(uint256_t(row->value), Member));
+  }
+
+  // Reads a string member of any length
+  template <auto Member, typename Layout, typename T>
+  inline std::string readStringMember(const storage_struct<Layout, T>& s)
+  {
+    static_assert(Layout::types[Member] == sol_type::string, "Member is not a string");
+    return readStringFromStorage(s.states_bykey, s.slot(Member));
+  }
+} // namespace evm_bridge
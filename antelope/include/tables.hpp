@@ -16,7 +16,7 @@ namespace evm_bridge {
      typedef eosio::multi_index< "stat"_n, currency_stats > eosio_tokens;
 
     //======================== Tables ========================
-    // Bridge requests
+    // Legacy in flight bridge requests, paid out before the dedupe rows existed: their ids count as processed until droplegacy erases them
     struct [[eosio::table, eosio::contract("token.brdg")]] requests {
         uint64_t request_id;
         eosio::checksum256 call_id;
@@ -33,7 +33,7 @@ namespace evm_bridge {
        indexed_by<"timestamp"_n, const_mem_fun<requests, uint64_t, &requests::by_timestamp >>
     >  requests_table;
 
-    // Bridge refunds
+    // Legacy in flight bridge refunds, paid out before the dedupe rows existed: their ids count as processed until droplegacy erases them
     struct [[eosio::table, eosio::contract("token.brdg")]] refunds {
         uint64_t refund_id;
         eosio::checksum256 call_id;
@@ -50,6 +50,292 @@ namespace evm_bridge {
        indexed_by<"timestamp"_n, const_mem_fun<refunds, uint64_t, &refunds::by_timestamp >>
     >  refunds_table;
 
+    // Pairs (cache of the EVM PairBridgeRegister pairs, scoped by Antelope token contract)
+    struct [[eosio::table, eosio::contract("token.brdg")]] pairs {
+        eosio::symbol_code antelope_symbol;
+        uint64_t evm_pair_id;
+        uint64_t evm_index;
+        eosio::checksum160 evm_address;
+        uint8_t evm_decimals;
+        bool active;
+        std::string evm_symbol;
+        std::string evm_name;
+
+        uint64_t primary_key() const { return antelope_symbol.raw(); };
+
+        EOSLIB_SERIALIZE(pairs, (antelope_symbol)(evm_pair_id)(evm_index)(evm_address)(evm_decimals)(active)(evm_symbol)(evm_name));
+    };
+    typedef multi_index<name("pairs"), pairs> pairs_table;
+
+    // Where the pairs cache row of each EVM pair id is, so syncpairs finds the rows of the pairs removed from the register
+    struct [[eosio::table, eosio::contract("token.brdg")]] pairkeys {
+        uint64_t evm_pair_id;
+        eosio::name token_contract;
+        eosio::symbol_code antelope_symbol;
+
+        uint64_t primary_key() const { return evm_pair_id; };
+
+        EOSLIB_SERIALIZE(pairkeys, (evm_pair_id)(token_contract)(antelope_symbol));
+    };
+    typedef multi_index<name("pairkeys"), pairkeys> pairkeys_table;
+
+    // Deposits waiting for the next bridgeToBatch call, while batching is on
+    struct [[eosio::table, eosio::contract("token.brdg")]] deposits {
+        uint64_t id;
+        eosio::checksum160 evm_token;
+        eosio::checksum160 receiver;
+        eosio::checksum256 amount;
+        eosio::name sender;
+        eosio::name token_contract;
+        eosio::asset quantity;
+
+        uint64_t primary_key() const { return id; };
+
+        EOSLIB_SERIALIZE(deposits, (id)(evm_token)(receiver)(amount)(sender)(token_contract)(quantity));
+    };
+    typedef multi_index<name("deposits"), deposits> deposits_table;
+
+    // Pairs sync cursor
+    struct [[eosio::table, eosio::contract("token.brdg")]] pairsync {
+        uint64_t next_index = 0;
+        uint64_t next_key = 0; // pairkeys row the check for removed pairs resumes at
+
+        EOSLIB_SERIALIZE(pairsync, (next_index)(next_key));
+    };
+
+    typedef singleton<"pairsync"_n, pairsync> pairsync_singleton;
+
+    // Next EVM nonce to hand out, ahead of the eosio.evm account nonce while raw calls sent earlier in the transaction are still queued
+    struct [[eosio::table, eosio::contract("token.brdg")]] nonces {
+        uint64_t next = 0;
+
+        EOSLIB_SERIALIZE(nonces, (next));
+    };
+
+    typedef singleton<"nonces"_n, nonces> nonces_singleton;
+
+    // Processed ids of a notify queue, scoped by queue ("requests"_n or "refunds"_n) & split into NOTIFY_PARTITIONS rows
+    // by id modulo NOTIFY_PARTITIONS, so an id is recorded in the same row whatever the shard count of the crank paying it
+    // A row counts the ids of its partition by rank, id / NOTIFY_PARTITIONS: every rank below the watermark has been
+    // processed, bit n of the window marks watermark + n as processed
+    struct [[eosio::table, eosio::contract("token.brdg")]] dedupe {
+        uint64_t partition = 0;
+        uint64_t watermark = 0;
+        std::vector<uint64_t> window = std::vector<uint64_t>(DEDUPE_WINDOW_WORDS, 0);
+
+        uint64_t primary_key() const { return partition; };
+
+        static uint64_t partitionOf(uint64_t id) { return id % NOTIFY_PARTITIONS; }
+        static uint64_t rankOf(uint64_t id) { return id / NOTIFY_PARTITIONS; }
+
+        // Rank of the first id of this partition at or above `id`
+        uint64_t rankFrom(uint64_t id) const { return id > partition ? (id - partition + NOTIFY_PARTITIONS - 1) / NOTIFY_PARTITIONS : 0; }
+
+        // Ranks past the window cannot be recorded until the watermark catches up
+        bool fits(uint64_t rank) const { return rank - watermark < window.size() * 64; }
+
+        bool contains(uint64_t rank) const {
+            if(rank < watermark) return true;
+            if(!fits(rank)) return false;
+            const uint64_t offset = rank - watermark;
+            return (window[offset / 64] >> (offset % 64)) & 1;
+        }
+
+        // Records a rank, false when it is past the window
+        bool insert(uint64_t rank) {
+            if(rank < watermark) return true;
+            if(!fits(rank)) return false;
+            const uint64_t offset = rank - watermark;
+            window[offset / 64] |= uint64_t(1) << (offset % 64);
+            return true;
+        }
+
+        // Moves the watermark past the ids processed right above it
+        void advance() {
+            uint64_t processed = 0;
+            for(const uint64_t word : window){
+                if(word != ~uint64_t(0)){
+                    processed += __builtin_ctzll(~word);
+                    break;
+                }
+                processed += 64;
+            }
+            shift(processed);
+        }
+
+        // Every rank below `next` has been processed or is gone from EVM
+        void moveTo(uint64_t next) {
+            if(next > watermark){
+                shift(next - watermark);
+            }
+        }
+
+        EOSLIB_SERIALIZE(dedupe, (partition)(watermark)(window));
+
+        private:
+            void shift(uint64_t count) {
+                watermark += count;
+                const size_t words = count / 64;
+                const size_t bits = count % 64;
+                for(size_t w = 0; w < window.size(); w++){
+                    const size_t from = w + words;
+                    uint64_t word = from < window.size() ? window[from] >> bits : 0;
+                    if(bits && from + 1 < window.size()) word |= window[from + 1] << (64 - bits);
+                    window[w] = word;
+                }
+            }
+    };
+
+    typedef multi_index<"dedupe"_n, dedupe> dedupe_table;
+
+    // The pass of a shard over a notify queue's EVM array, scoped by queue & keyed by shard
+    // A pass scans the array down from its last item over as many calls as it takes, so paid items swapped & popped on
+    // EVM never move an item it has not scanned yet behind it. Once it reaches the first item, every id of the shard
+    // below the floor was seen & processed or is gone from EVM, and the shard's dedupe watermarks move up to it
+    struct [[eosio::table, eosio::contract("token.brdg")]] notifyscan {
+        uint64_t shard; // shard_count << 32 | shard_id
+        uint64_t cursor = 0; // items of the array left to scan, 0 once the pass is over
+        uint64_t pass_end = 0; // the EVM id counter when the pass started, ids pushed since are not all scanned
+        uint64_t floor = 0; // pass_end, or the first id of the shard left past its dedupe window
+
+        uint64_t primary_key() const { return shard; };
+
+        EOSLIB_SERIALIZE(notifyscan, (shard)(cursor)(pass_end)(floor));
+    };
+
+    typedef multi_index<"notifyscan"_n, notifyscan> notify_scans_table;
+
+    // Per token operational metrics, scoped by Antelope token contract
+    struct [[eosio::table, eosio::contract("token.brdg")]] tokenstats {
+        eosio::symbol symbol;
+        uint64_t bridged = 0;
+        uint64_t requests_processed = 0;
+        uint64_t refunds_processed = 0;
+        int64_t bridged_amount = 0;
+        int64_t requests_amount = 0;
+        int64_t refunds_amount = 0;
+        // The host work of the transfers bridged, so bridge() writes a single metrics row
+        uint64_t slots_read = 0;
+        uint64_t inline_actions = 0;
+        uint64_t batches_sent = 0;
+        uint64_t deposits_returned = 0;
+
+        uint64_t primary_key() const { return symbol.code().raw(); };
+
+        void add(const tokenstats& other) {
+            bridged += other.bridged;
+            requests_processed += other.requests_processed;
+            refunds_processed += other.refunds_processed;
+            bridged_amount += other.bridged_amount;
+            requests_amount += other.requests_amount;
+            refunds_amount += other.refunds_amount;
+            slots_read += other.slots_read;
+            inline_actions += other.inline_actions;
+            batches_sent += other.batches_sent;
+            deposits_returned += other.deposits_returned;
+        }
+
+        EOSLIB_SERIALIZE(tokenstats, (symbol)(bridged)(requests_processed)(refunds_processed)(bridged_amount)(requests_amount)(refunds_amount)(slots_read)(inline_actions)(batches_sent)(deposits_returned));
+    };
+    typedef multi_index<name("tokenstats"), tokenstats> tokenstats_table;
+
+    // Operational metrics, cumulative since the contract was initialized
+    // bridge() keeps its counts in the transfer's tokenstats row only, add those rows in for the totals
+    struct [[eosio::table, eosio::contract("token.brdg")]] stats {
+        uint64_t requests_processed = 0;    // EVM bridge requests paid out
+        uint64_t refunds_processed = 0;     // EVM refunds paid out, or settled when unresolved
+        uint64_t refunds_unresolved = 0;    // EVM refunds without an Antelope token to pay them in, settled without a transfer
+        uint64_t registrations_signed = 0;  // EVM registration requests signed
+        uint64_t duplicates_skipped = 0;    // requests & refunds found in the dedupe window
+        uint64_t watermark_skipped = 0;     // requests & refunds below the dedupe watermark
+        uint64_t slots_read = 0;            // EVM storage slots read
+        uint64_t inline_actions = 0;        // inline actions sent
+        uint64_t rows_pruned = 0;           // rows erased from the legacy requests & refunds tables
+        uint64_t notify_calls = 0;          // reqnotify & refundnotify calls
+        uint64_t batches_sent = 0;          // bridgeToBatch calls, each carrying the deposits queued before it
+        uint64_t deposits_returned = 0;     // queued deposits sent back on Antelope as their pair left the register
+        time_point last_update;
+
+        void add(const stats& other) {
+            requests_processed += other.requests_processed;
+            refunds_processed += other.refunds_processed;
+            refunds_unresolved += other.refunds_unresolved;
+            registrations_signed += other.registrations_signed;
+            duplicates_skipped += other.duplicates_skipped;
+            watermark_skipped += other.watermark_skipped;
+            slots_read += other.slots_read;
+            inline_actions += other.inline_actions;
+            rows_pruned += other.rows_pruned;
+            notify_calls += other.notify_calls;
+            batches_sent += other.batches_sent;
+            deposits_returned += other.deposits_returned;
+        }
+
+        // Adds the counts bridge() kept in a tokenstats row
+        void add(const tokenstats& token) {
+            slots_read += token.slots_read;
+            inline_actions += token.inline_actions;
+            batches_sent += token.batches_sent;
+            deposits_returned += token.deposits_returned;
+        }
+
+        EOSLIB_SERIALIZE(stats, (requests_processed)(refunds_processed)(refunds_unresolved)(registrations_signed)(duplicates_skipped)(watermark_skipped)(slots_read)(inline_actions)(rows_pruned)(notify_calls)(batches_sent)(deposits_returned)(last_update));
+    };
+
+    typedef singleton<"stats"_n, stats> stats_singleton;
+
+    // Per token metrics of one shard, by Antelope token contract
+    struct shardtoken {
+        eosio::name contract;
+        tokenstats totals;
+
+        EOSLIB_SERIALIZE(shardtoken, (contract)(totals));
+    };
+
+    // Metrics of the sharded notify cranks, one row per shard so shards never write the same row
+    // The contract totals are the stats singleton & tokenstats rows plus every shardstats row
+    struct [[eosio::table, eosio::contract("token.brdg")]] shardstats {
+        uint64_t shard; // shard_count << 32 | shard_id
+        stats totals;
+        std::vector<shardtoken> tokens;
+
+        uint64_t primary_key() const { return shard; };
+
+        EOSLIB_SERIALIZE(shardstats, (shard)(totals)(tokens));
+    };
+    typedef multi_index<name("shardstats"), shardstats> shardstats_table;
+
+    // EVM gas limit of a call type: a base, plus per id / deposit of a batch & per byte of the strings passed
+    struct gas_model {
+        uint64_t base;
+        uint64_t per_item;
+        uint64_t per_byte;
+
+        uint64_t limit(uint64_t items, uint64_t bytes) const {
+            const uint64_t gas = base + per_item * items + per_byte * bytes;
+            check(gas <= MAX_CALL_GAS, "EVM call gas limit is above the max call gas");
+            return gas;
+        }
+
+        EOSLIB_SERIALIZE(gas_model, (base)(per_item)(per_byte));
+    };
+
+    // Settings added after the first deployment, in a row of their own so the stored bridgeconfig row keeps unpacking
+    // Missing until the admin sets one of them, every setting keeps its default until then
+    struct [[eosio::table, eosio::contract("token.brdg")]] settings {
+        uint64_t notify_max_items = DEFAULT_NOTIFY_MAX_ITEMS;
+        uint64_t notify_max_cost = DEFAULT_NOTIFY_BUDGET;
+        uint64_t bridge_batch_size = 0; // deposits per bridgeToBatch call, 0 sends each deposit on its own
+        gas_model bridge_gas { BRIDGE_BATCH_GAS, BRIDGE_BATCH_ITEM_GAS, 0 }; // bridgeTo & bridgeToBatch, per deposit & per byte of the sender & Antelope token names
+        gas_model success_gas { SUCCESS_CB_GAS, SUCCESS_CB_ITEM_GAS, 0 }; // requestsSuccessful, per id
+        gas_model refund_gas { REFUND_CB_GAS, REFUND_CB_ITEM_GAS, 0 }; // refundsSuccessful, per id
+        gas_model register_gas { SIGN_REGISTRATION_GAS, 0, 0 }; // signRegistrationRequest, per account, issuer & symbol name byte
+
+        EOSLIB_SERIALIZE(settings, (notify_max_items)(notify_max_cost)(bridge_batch_size)(bridge_gas)(success_gas)(refund_gas)(register_gas));
+    };
+
+    typedef singleton<"settings"_n, settings> settings_singleton;
+
     // Config
     struct [[eosio::table, eosio::contract("token.brdg")]] bridgeconfig {
         eosio::checksum160 evm_bridge_address;
@@ -3,6 +3,8 @@
 // @contract token.brdg
 // @version v1.0
 
+#pragma once
+
 // EOSIO
 #include <eosio/eosio.hpp>
 #include <eosio/singleton.hpp>
@@ -15,15 +17,24 @@
 #include <intx/base.hpp>
 #include <rlp/rlp.hpp>
 #include <ecc/uECC.c>
-#include <keccak256/k.c>
-#include <boost/multiprecision/cpp_int.hpp>
 
 // TELOS EVM
+#include <compile_time.hpp>
 #include <constants.hpp>
+#include <keccak.hpp>
+#include <budget.hpp>
+#include <queries.hpp>
 #include <evm_util.hpp>
+#include <storage_layout.hpp>
+#include <abi.hpp>
+#include <evm_tx.hpp>
+#include <decimals.hpp>
 #include <datastream.hpp>
 #include <evm_tables.hpp>
 #include <tables.hpp>
+#include <stats.hpp>
+#include <nonce.hpp>
+#include <notify.hpp>
 
 using namespace std;
 using namespace eosio;
@@ -35,7 +46,7 @@ namespace evm_bridge
     class [[eosio::contract("token.brdg")]] tokenbridge : public contract {
         public:
             using contract::contract;
-            tokenbridge(name self, name code, datastream<const char*> ds) : contract(self, code, ds), config_bridge(self, self.value), config(EVM_SYSTEM_CONTRACT, EVM_SYSTEM_CONTRACT.value) { };
+            tokenbridge(name self, name code, datastream<const char*> ds) : contract(self, code, ds), config_bridge(self, self.value), config_settings(self, self.value), config(EVM_SYSTEM_CONTRACT, EVM_SYSTEM_CONTRACT.value) { };
             ~tokenbridge() {};
 
             //======================== Admin actions ========================
@@ -45,29 +56,82 @@ namespace evm_bridge
             // set the contract version
             [[eosio::action]] void setversion(std::string new_version);
 
-            // set the bridge & register evm addresses
+            // set the bridge & register evm addresses, a new bridge address resets the dedupe rows & scan cursors
             [[eosio::action]] void setevmctc(eosio::checksum160 bridge_address, eosio::checksum160 register_address);
 
             // set new contract admin
             [[eosio::action]] void setadmin(eosio::name new_admin);
 
+            // set the max items & max estimated cost per notify action call
+            [[eosio::action]] void setnotify(uint64_t max_items, uint64_t max_cost);
+
+            // erase up to `max` legacy requests & refunds rows, recording their ids in the dedupe rows first
+            [[eosio::action]] void droplegacy(uint64_t max);
+
+            // queue deposits & send them to EVM `batch_size` at a time, 0 sends each deposit on its own
+            [[eosio::action]] void setbatch(uint64_t batch_size);
+
+            // set the EVM gas limit model of a call: bridge, success, refund or register
+            [[eosio::action]] void setgas(eosio::name call, uint64_t base, uint64_t per_item, uint64_t per_byte);
+
             //======================== Token bridge actions ========================
 
-            // Notifies Antelope of a refund in EVM
-            [[eosio::action]] void refundnotify();
+            // Notifies Antelope of a refund in EVM, the ones of shard `shard_id` out of `shard_count` (0 out of 1 for all of them)
+            [[eosio::action]] notify_result refundnotify(uint64_t shard_id, uint64_t shard_count);
+
+            // Notifies Antelope of a bridge request in EVM, the ones of shard `shard_id` out of `shard_count`
+            [[eosio::action]] notify_result reqnotify(uint64_t shard_id, uint64_t shard_count);
 
-            // Notifies Antelope of a bridge request in EVM
-            [[eosio::action]] void reqnotify();
+            // Pays out both the bridge requests & the refunds in EVM, sharing the lookups of one transaction
+            [[eosio::action]] notify_result process(uint64_t shard_id, uint64_t shard_count);
 
             // Signs EVM registration request from Antelope
             [[eosio::action]] void signregpair(eosio::checksum160 evm_address, eosio::name account, eosio::symbol symbol, uint64_t request_id);
 
+            // Syncs the pairs cache from the EVM PairBridgeRegister, erasing the pairs it removed
+            [[eosio::action]] void syncpairs(uint64_t max);
+
             // Bridge to EVM
             [[eosio::on_notify("*::transfer")]] void bridge(eosio::name from, eosio::name to, eosio::asset quantity, std::string memo);
 
+            // Sends up to `max` queued deposits to EVM in a single bridgeToBatch call
+            [[eosio::action]] void flush(uint64_t max);
+
+            //======================== Read only queries ========================
+
+            // Lists the EVM bridge requests not paid out yet, a page of the TokenBridge requests[] array at a time
+            [[eosio::action, eosio::read_only]] pending_requests pending(uint64_t offset, uint64_t limit);
+
+            // Lists the EVM refunds not paid back yet, a page of the TokenBridge refunds[] array at a time
+            [[eosio::action, eosio::read_only]] pending_refunds pendrefunds(uint64_t offset, uint64_t limit);
+
+            // Lists the EVM PairBridgeRegister pairs, a page of its pairs[] array at a time
+            [[eosio::action, eosio::read_only]] evm_pairs evmpairs(uint64_t offset, uint64_t limit);
+
+            // Dry run of reqnotify
+            [[eosio::action, eosio::read_only]] notify_preview reqpreview();
+
             config_singleton_bridge config_bridge;
+            settings_singleton config_settings;
             config_singleton_evm config;
 
+        private:
+            uint64_t flushDeposits(const bridgeconfig& conf, const settings& tuning, uint64_t max, stats_recorder& recorder);
+
+            notify_result processRequests(notify_context& ctx, uint64_t request_count, std::vector<pending_request>* preview);
+            notify_result processRefunds(notify_context& ctx, uint64_t refund_count);
+
+            template <typename T>
+            pending_request readRequest(const storage_struct<request_layout, T>& request_storage, uint64_t call_id, token_symbols& symbols);
+
+            template <typename T>
+            pending_refund readRefund(const storage_struct<refund_layout, T>& refund_storage, uint64_t refund_id, token_symbols& symbols);
+
+            template <typename T>
+            evm_pair readPair(const storage_struct<pair_layout, T>& pair_storage);
+
+        public:
+
             #if (TESTING == true)
                 [[eosio::action]] void clear()
                 {
@@ -83,6 +147,34 @@ namespace evm_bridge
                     {
                       itr_refunds = refunds.erase(--itr_refunds);
                     }
+                    deposits_table deposits(get_self(), get_self().value);
+                    auto itr_deposits = deposits.end();
+                    while (deposits.begin() != itr_deposits)
+                    {
+                      itr_deposits = deposits.erase(--itr_deposits);
+                    }
+                    pairsync_singleton pairsync(get_self(), get_self().value);
+                    pairsync.remove();
+                    pairkeys_table keys(get_self(), get_self().value);
+                    for(auto itr = keys.begin(); itr != keys.end();){
+                        itr = keys.erase(itr);
+                    }
+                    for(const eosio::name queue : { "requests"_n, "refunds"_n }){
+                        dedupe_table dedupe_rows(get_self(), queue.value);
+                        for(auto itr = dedupe_rows.begin(); itr != dedupe_rows.end();){
+                            itr = dedupe_rows.erase(itr);
+                        }
+                        notify_scans_table scans(get_self(), queue.value);
+                        for(auto itr = scans.begin(); itr != scans.end();){
+                            itr = scans.erase(itr);
+                        }
+                    }
+                    stats_singleton stats(get_self(), get_self().value);
+                    stats.remove();
+                    shardstats_table shards(get_self(), get_self().value);
+                    for(auto itr = shards.begin(); itr != shards.end();){
+                        itr = shards.erase(itr);
+                    }
                 }
             #endif
     };
@@ -0,0 +1,250 @@
+// Native microbenchmarks of the contract's hot path primitives
+// Build with CMake from antelope/, then run ./bench [--filter <name>] [--min-time-ms <ms>] [--csv]
+
+#include <eosio/eosio.hpp>
+#include <eosio/asset.hpp>
+#include <eosio/check.hpp>
+#include <eosio/crypto.hpp>
+#include <eosio/datastream.hpp>
+#include <eosio/name.hpp>
+#include <eosio/symbol.hpp>
+
+#include <intx/base.hpp>
+#include <rlp/rlp.hpp>
+#include <keccak256/k.c>
+
+#include <compile_time.hpp>
+#include <constants.hpp>
+#include <keccak.hpp>
+#include <evm_util.hpp>
+#include <storage_layout.hpp>
+#include <abi.hpp>
+#include <evm_tx.hpp>
+#include <decimals.hpp>
+
+#include "bench.hpp"
+
+#include <cstdlib>
+#include <map>
+#include <new>
+
+using namespace evm_bridge;
+
+//======================== Allocation counting ========================
+
+bench::alloc_stats& bench::allocs()
+{
+  static alloc_stats stats;
+  return stats;
+}
+
+void* operator new(std::size_t size)
+{
+  bench::allocs().allocations++;
+  bench::allocs().bytes += size;
+  if (void* p = std::malloc(size ? size : 1)) return p;
+  throw std::bad_alloc();
+}
+
+// Every form of delete goes through the unsized one, kept out of line so the compiler never sees a free() paired with a new
+void* operator new[](std::size_t size) { return operator new(size); }
+[[gnu::noinline]] void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { operator delete(p); }
+void operator delete(void* p, std::size_t) noexcept { operator delete(p); }
+void operator delete[](void* p, std::size_t) noexcept { operator delete(p); }
+
+//======================== Fixtures ========================
+
+namespace
+{
+  // Solidity short string layout: bytes left aligned, length * 2 in the last byte
+  uint256_t storageString(const std::string& value)
+  {
+    std::array<uint8_t, 32u> word = {};
+    memcpy(word.data(), value.data(), value.size());
+    word[31] = uint8_t(value.size() * 2);
+    return bytesToValue(word);
+  }
+
+  // eosio.evm accountstate rows of the TokenBridge contract, keyed like the bykey index
+  struct storage {
+    std::map<eosio::checksum256, uint256_t> rows;
+
+    uint256_t word(const eosio::checksum256& key) const
+    {
+      const auto row = rows.find(key);
+      return row != rows.end() ? row->second : uint256_t(0); // missing rows are zero words
+    }
+  };
+
+  storage bridgeStorage(uint64_t request_count)
+  {
+    storage s;
+    const uint256_t base = bytesToValue(STORAGE_BRIDGE_REQUEST_SLOT);
+    s.rows[toChecksum256(STORAGE_BRIDGE_REQUEST_INDEX)] = request_count;
+    for (uint64_t i = 0; i < request_count; i++) {
+      s.rows[getStructMemberSlot<request_layout>(base, request_layout::id, i)] = i + 1;
+      s.rows[getStructMemberSlot<request_layout>(base, request_layout::sender, i)] = uint256_t(0x5b38da6a701c5685ULL) << 96;
+      s.rows[getStructMemberSlot<request_layout>(base, request_layout::amount, i)] = uint256_t(12345) * POW10[14];
+      s.rows[getStructMemberSlot<request_layout>(base, request_layout::requested_at, i)] = 1700000000 + i;
+      s.rows[getStructMemberSlot<request_layout>(base, request_layout::antelope_token, i)] = storageString("eosio.token");
+      s.rows[getStructMemberSlot<request_layout>(base, request_layout::antelope_symbol, i)] = storageString("TLOS");
+      s.rows[getStructMemberSlot<request_layout>(base, request_layout::receiver, i)] = storageString("receiver1234");
+      s.rows[getStructMemberSlot<request_layout>(base, request_layout::evm_decimals, i)] = 18;
+    }
+    return s;
+  }
+
+  // Keccak-256 of the vendored k.c, the reference keccak_256 is timed against
+  std::array<uint8_t, 32u> keccakReference(const uint8_t* data, size_t size)
+  {
+    SHA3_CTX context;
+    std::array<uint8_t, 32u> output;
+    keccak_init(&context);
+    keccak_update(&context, data, size);
+    keccak_final(&context, output.data());
+    return output;
+  }
+
+  const eosio::name SELF = eosio::name("token.brdg");
+  const eosio::checksum160 BRIDGE_ADDRESS = addressToChecksum160(uint256_t(0xdeadbeefcafeULL));
+  const eosio::checksum160 SELF_ADDRESS = addressToChecksum160(uint256_t(0xfeedULL));
+
+  // Everything reqnotify does for one request paid out on its own, minus the host calls
+  std::pair<std::vector<char>, std::vector<char>> processRequest(const storage& s, uint64_t i, uint64_t nonce)
+  {
+    const uint256_t base = bytesToValue(STORAGE_BRIDGE_REQUEST_SLOT);
+    const uint256_t call_id = s.word(getStructMemberSlot<request_layout>(base, request_layout::id, i));
+    const eosio::name token_account_name = parseNameFromStorage(s.word(getStructMemberSlot<request_layout>(base, request_layout::antelope_token, i)));
+    const uint64_t evm_decimals = static_cast<uint64_t>(s.word(getStructMemberSlot<request_layout>(base, request_layout::evm_decimals, i)));
+    const eosio::name receiver = parseNameFromStorage(s.word(getStructMemberSlot<request_layout>(base, request_layout::receiver, i)));
+    const eosio::symbol_code antelope_symbol = parseSymbolCodeFromStorage(s.word(getStructMemberSlot<request_layout>(base, request_layout::antelope_symbol, i)));
+    const std::string memo = "Sent from tEVM by 0x" + bin2hex(parseAddressFromStorage(s.word(getStructMemberSlot<request_layout>(base, request_layout::sender, i))));
+
+    const uint256_t amount = s.word(getStructMemberSlot<request_layout>(base, request_layout::amount, i));
+    const eosio::asset quantity(toAntelopeAmount(amount, 4, evm_decimals), eosio::symbol(antelope_symbol, 4));
+    std::vector<char> transfer = eosio::pack(std::make_tuple(SELF, receiver, quantity, memo));
+    bench::doNotOptimize(token_account_name);
+
+    const std::vector<uint8_t> data = EVM_SUCCESS_CALLBACKS_CALL.encode(std::vector<uint256_t> { call_id });
+    const std::vector<int8_t> tx = encodeTransaction(nonce, uint256_t(500000000000ULL), SUCCESS_CB_GAS, BRIDGE_ADDRESS, uint256_t(0), data, CURRENT_CHAIN_ID);
+    std::vector<char> raw = eosio::pack(std::make_tuple(SELF, tx, false, std::optional<eosio::checksum160>(SELF_ADDRESS)));
+    return { std::move(transfer), std::move(raw) };
+  }
+}
+
+//======================== Main ========================
+
+int main(int argc, char** argv)
+{
+  bench::options opts;
+  for (int i = 1; i < argc; i++) {
+    const std::string arg = argv[i];
+    if (arg == "--filter" && i + 1 < argc) opts.filter = argv[++i];
+    else if (arg == "--min-time-ms" && i + 1 < argc) opts.min_time_ns = std::strtoull(argv[++i], nullptr, 10) * 1000000;
+    else if (arg == "--csv") opts.csv = true;
+    else {
+      std::fprintf(stderr, "usage: %s [--filter <name>] [--min-time-ms <ms>] [--csv]\n", argv[0]);
+      return 1;
+    }
+  }
+
+  // The contract's paths must produce the bytes of the reference implementations they are timed against
+  const std::vector<uint8_t> kilobyte(1024, 0xab);
+  const auto slot_key = toChecksum256(STORAGE_BRIDGE_REQUEST_INDEX).extract_as_byte_array();
+  for (const std::vector<uint8_t>& input : { std::vector<uint8_t>(slot_key.begin(), slot_key.end()), kilobyte }) {
+    if (keccak_256(input) != keccakReference(input.data(), input.size())) {
+      std::fprintf(stderr, "keccak_256 differs from keccak256/k.c over %zu bytes\n", input.size());
+      return 1;
+    }
+  }
+  const std::string account = "eosio.token";
+  const std::string issuer = "tokenissuer1";
+  const std::string symbol = "TLOS";
+  const std::vector<uint8_t> calldata = EVM_SIGN_REGISTRATION_CALL.encode(uint256_t(1), uint256_t(4), account, issuer, symbol);
+  const auto to_bytes = BRIDGE_ADDRESS.extract_as_byte_array();
+  const std::vector<uint8_t> to(to_bytes.begin(), to_bytes.end());
+  for (const uint64_t nonce : { 0ULL, 1ULL, 127ULL, 128ULL, 65536ULL, 1ULL << 40 }) {
+    const std::vector<int8_t> single_pass = encodeTransaction(nonce, uint256_t(500000000000ULL), SIGN_REGISTRATION_GAS, BRIDGE_ADDRESS, uint256_t(0), calldata, CURRENT_CHAIN_ID);
+    const auto reference = rlp::encode(nonce, uint256_t(500000000000ULL), SIGN_REGISTRATION_GAS, to, uint256_t(0), calldata, CURRENT_CHAIN_ID, 0, 0);
+    if (single_pass.size() != reference.size() || memcmp(single_pass.data(), reference.data(), reference.size()) != 0) {
+      std::fprintf(stderr, "encodeTransaction differs from rlp::encode at nonce %llu\n", (unsigned long long)nonce);
+      return 1;
+    }
+  }
+
+  bench::runner r(opts);
+  r.header();
+
+  // Storage slots
+  const uint256_t request_base = bytesToValue(STORAGE_BRIDGE_REQUEST_SLOT);
+  uint64_t index = 0;
+  r.run("getArrayMemberSlot", [&] {
+    bench::doNotOptimize(getArrayMemberSlot(request_base, 5, request_layout::slot_count, index++));
+  });
+  r.run("arrayBaseSlot (runtime)", [&] {
+    const uint8_t storage_index = uint8_t(index++);
+    bench::doNotOptimize(arrayBaseSlot(storage_index));
+  });
+  r.run("getMappingSlot (address key)", [&] {
+    bench::doNotOptimize(getMappingSlot(uint256_t(index++), STORAGE_REGISTER_PAIR_BY_TOKEN_INDEX));
+  });
+  const std::string symbol_key = "TLOS";
+  r.run("getMappingSlot (string key)", [&] {
+    bench::doNotOptimize(getMappingSlot(symbol_key, STORAGE_REGISTER_PAIR_BY_SYMBOL_INDEX));
+  });
+
+  // Keccak
+  r.run("keccak_256 (32 bytes)", [&] {
+    bench::doNotOptimize(keccak_256(slot_key));
+  });
+  r.run("keccak256/k.c (32 bytes)", [&] {
+    bench::doNotOptimize(keccakReference(slot_key.data(), slot_key.size()));
+  });
+  r.run("keccak_256 (1 KiB)", [&] {
+    bench::doNotOptimize(keccak_256(kilobyte));
+  });
+
+  // Calldata
+  r.run("abi encode signRegistrationRequest", [&] {
+    bench::doNotOptimize(EVM_SIGN_REGISTRATION_CALL.encode(uint256_t(index++), uint256_t(4), account, issuer, symbol));
+  });
+  std::vector<uint256_t> call_ids(DEFAULT_NOTIFY_MAX_ITEMS);
+  r.run("abi encode requestsSuccessful (10 ids)", [&] {
+    for (auto& id : call_ids) id = index++;
+    bench::doNotOptimize(EVM_SUCCESS_CALLBACKS_CALL.encode(call_ids));
+  });
+
+  // RLP
+  r.run("rlp::encode transaction", [&] {
+    bench::doNotOptimize(rlp::encode(index++, uint256_t(500000000000ULL), SIGN_REGISTRATION_GAS, to, uint256_t(0), calldata, CURRENT_CHAIN_ID, 0, 0));
+  });
+  r.run("encodeTransaction", [&] {
+    bench::doNotOptimize(encodeTransaction(index++, uint256_t(500000000000ULL), SIGN_REGISTRATION_GAS, BRIDGE_ADDRESS, uint256_t(0), calldata, CURRENT_CHAIN_ID));
+  });
+
+  // Storage parsing
+  const uint256_t name_word = storageString("eosio.token");
+  const uint256_t symbol_word = storageString("TLOS");
+  r.run("parseNameFromStorage", [&] {
+    bench::doNotOptimize(parseNameFromStorage(name_word));
+  });
+  r.run("parseSymbolCodeFromStorage", [&] {
+    bench::doNotOptimize(parseSymbolCodeFromStorage(symbol_word));
+  });
+
+  // Decimals
+  const uint256_t wei = uint256_t(12345) * POW10[14];
+  r.run("toAntelopeAmount", [&] {
+    bench::doNotOptimize(toAntelopeAmount(wei, 4, 18));
+  });
+
+  // Full request, as processed by reqnotify
+  const storage bridge = bridgeStorage(64);
+  r.run("reqnotify per request (no host calls)", [&] {
+    const uint64_t nonce = index++;
+    bench::doNotOptimize(processRequest(bridge, nonce % 64, nonce));
+  });
+
+  return 0;
+}
@@ -0,0 +1,102 @@
+// Minimal microbenchmark runner: ns/op & heap allocations/op for each registered case
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace bench
+{
+  /**
+   * Heap usage since the process started, fed by the operator new replacement in bench.cpp
+   */
+  struct alloc_stats {
+    uint64_t allocations = 0;
+    uint64_t bytes = 0;
+  };
+
+  alloc_stats& allocs();
+
+  // Keeps the optimizer from dropping a value that is never used
+  template <typename T>
+  inline void doNotOptimize(const T& value)
+  {
+    asm volatile("" : : "r,m"(value) : "memory");
+  }
+
+  struct result {
+    std::string name;
+    uint64_t iterations;
+    double ns_per_op;
+    double allocs_per_op;
+    double bytes_per_op;
+  };
+
+  struct options {
+    std::string filter;
+    uint64_t min_time_ns = 200000000; // 200ms per case
+    bool csv = false;
+  };
+
+  class runner {
+    public:
+      explicit runner(options opts) : opts(std::move(opts)) {}
+
+      // Runs `fn` in growing batches until the minimum time is reached
+      void run(const std::string& name, const std::function<void()>& fn)
+      {
+        if (!opts.filter.empty() && name.find(opts.filter) == std::string::npos) return;
+
+        fn(); // warm up
+        uint64_t iterations = 1;
+        while (true) {
+          const alloc_stats before = allocs();
+          const auto start = std::chrono::steady_clock::now();
+          for (uint64_t i = 0; i < iterations; i++) fn();
+          const uint64_t elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+          const alloc_stats after = allocs();
+
+          if (elapsed >= opts.min_time_ns || iterations >= (uint64_t(1) << 32)) {
+            results.push_back({
+              name,
+              iterations,
+              double(elapsed) / iterations,
+              double(after.allocations - before.allocations) / iterations,
+              double(after.bytes - before.bytes) / iterations
+            });
+            print(results.back());
+            return;
+          }
+          iterations *= (elapsed < opts.min_time_ns / 100) ? 10 : 2;
+        }
+      }
+
+      void header() const
+      {
+        if (opts.csv) {
+          std::printf("name,iterations,ns_per_op,allocs_per_op,bytes_per_op\n");
+        } else {
+          std::printf("%-40s %12s %12s %12s %12s\n", "benchmark", "iterations", "ns/op", "allocs/op", "bytes/op");
+        }
+      }
+
+      const std::vector<result>& all() const { return results; }
+
+    private:
+      void print(const result& r) const
+      {
+        if (opts.csv) {
+          std::printf("%s,%llu,%.1f,%.2f,%.1f\n", r.name.c_str(), (unsigned long long)r.iterations, r.ns_per_op, r.allocs_per_op, r.bytes_per_op);
+        } else {
+          std::printf("%-40s %12llu %12.1f %12.2f %12.1f\n", r.name.c_str(), (unsigned long long)r.iterations, r.ns_per_op, r.allocs_per_op, r.bytes_per_op);
+        }
+        std::fflush(stdout);
+      }
+
+      options opts;
+      std::vector<result> results;
+  };
+} // namespace bench
@@ -0,0 +1,201 @@
+// A deployed token.brdg in the emulator: eosio.evm accounts, TokenBridge & PairBridgeRegister storage, eosio.token stats
+// Include after the contract source, it runs the contract's own init
+#pragma once
+
+#include "emulator.hpp"
+
+namespace emulator
+{
+  /**
+   * TokenBridge requests[] & refunds[] and PairBridgeRegister pairs[] of a deployed bridge
+   */
+  struct bridge_fixture {
+    static constexpr eosio::name SELF = "token.brdg"_n;
+    static constexpr eosio::name TOKEN = "eosio.token"_n;
+    static constexpr uint8_t EVM_DECIMALS = 18;
+    static constexpr uint8_t ANTELOPE_PRECISION = 4;
+
+    static eosio::checksum160 selfAddress() { return addressToChecksum160(uint256_t(0xb0)); }
+    static eosio::checksum160 bridgeAddress() { return addressToChecksum160(uint256_t(0xb1)); }
+    static eosio::checksum160 registerAddress() { return addressToChecksum160(uint256_t(0xb2)); }
+    static eosio::checksum160 senderAddress() { return addressToChecksum160(uint256_t(0x5b38da6a701c5685ULL) << 96); }
+
+    // TAAA, TAAB... one Antelope symbol per pair
+    static eosio::symbol_code pairSymbol(uint64_t pair)
+    {
+      std::string code = "TAAA";
+      for (size_t i = code.size() - 1; i > 0; i--, pair /= 26) {
+        code[i] = char('A' + pair % 26);
+      }
+      return eosio::symbol_code(code);
+    }
+
+    static tokenbridge contract(eosio::name first_receiver = SELF)
+    {
+      return tokenbridge(SELF, first_receiver, eosio::datastream<const char*>(nullptr, 0));
+    }
+
+    // The contract's stats: the singleton plus the rows of the sharded cranks & the counts bridge() kept per token
+    static stats statsTotals()
+    {
+      stats totals = stats_singleton(SELF, SELF.value).get_or_default();
+      shardstats_table shards(SELF, SELF.value);
+      for (const auto& shard : shards) totals.add(shard.totals);
+      tokenstats_table tokens(SELF, TOKEN.value);
+      for (const auto& token : tokens) totals.add(token);
+      return totals;
+    }
+
+    // The tokenstats of a token contract, summed over its symbols & the sharded cranks
+    static tokenstats tokenTotals(eosio::name token_contract)
+    {
+      tokenstats totals;
+      tokenstats_table tokens(SELF, token_contract.value);
+      for (const auto& token : tokens) totals.add(token);
+      shardstats_table shards(SELF, SELF.value);
+      for (const auto& shard : shards) {
+        for (const auto& token : shard.tokens) {
+          if (token.contract == token_contract) totals.add(token.totals);
+        }
+      }
+      return totals;
+    }
+
+    uint64_t bridge_scope;
+    uint64_t register_scope;
+    uint64_t pair_count;
+    uint64_t next_id = 0;
+    evm_storage bridge;
+    evm_storage registry;
+    evm_array<request_layout> requests;
+    evm_array<refund_layout> refunds;
+    evm_array<pair_layout> pairs;
+
+    // Deploys the contract against `pair_count` registered pairs & empty queues
+    explicit bridge_fixture(uint64_t pair_count, uint64_t max_items = DEFAULT_NOTIFY_MAX_ITEMS, uint64_t max_cost = DEFAULT_NOTIFY_BUDGET)
+      : bridge_scope(deploy()), register_scope(bridge_scope + 1), pair_count(pair_count),
+        bridge(bridge_scope), registry(register_scope),
+        requests(bridge, STORAGE_BRIDGE_REQUEST_INDEX),
+        refunds(bridge, STORAGE_BRIDGE_REFUND_INDEX),
+        pairs(registry, STORAGE_REGISTER_PAIR_INDEX)
+    {
+      for (uint64_t p = 0; p < pair_count; p++) {
+        const eosio::symbol_code code = pairSymbol(p);
+        createToken(TOKEN, eosio::asset(eosio::asset::max_amount, eosio::symbol(code, ANTELOPE_PRECISION)), "issuer"_n);
+        const uint64_t i = pairs.push();
+        pairs.set(i, pair_layout::active, 1);
+        pairs.set(i, pair_layout::id, p + 1);
+        pairs.set(i, pair_layout::evm_address, uint256_t(0xe000 + p));
+        pairs.set(i, pair_layout::evm_decimals, EVM_DECIMALS);
+        pairs.set(i, pair_layout::antelope_decimals, ANTELOPE_PRECISION);
+        pairs.setString(i, pair_layout::antelope_issuer_name, "issuer");
+        pairs.setString(i, pair_layout::antelope_account_name, TOKEN.to_string());
+        pairs.setString(i, pair_layout::antelope_symbol_name, code.to_string());
+        pairs.setString(i, pair_layout::evm_symbol, "W" + code.to_string());
+        pairs.setString(i, pair_layout::evm_name, "Wrapped " + code.to_string() + " bridged from the Telos native chain"); // long string
+        registry.set(getMappingSlot(uint256_t(0xe000 + p), STORAGE_REGISTER_PAIR_BY_TOKEN_INDEX), i + 1);
+        registry.set(getMappingSlot(uint256_t(p + 1), STORAGE_REGISTER_PAIR_BY_ID_INDEX), i + 1);
+        registry.set(getMappingSlot(TOKEN.to_string(), STORAGE_REGISTER_PAIR_BY_ACCOUNT_INDEX), i + 1);
+        registry.set(getMappingSlot(code.to_string(), STORAGE_REGISTER_PAIR_BY_SYMBOL_INDEX), i + 1);
+      }
+
+      contract().init(bridgeAddress(), registerAddress(), "emulator", SELF);
+      contract().setnotify(max_items, max_cost);
+    }
+
+    // Queues `count` bridge requests & as many refunds on EVM, spread over the pairs
+    void queue(uint64_t count)
+    {
+      for (uint64_t n = 0; n < count; n++, next_id++) {
+        const std::string symbol = pairSymbol(next_id % pair_count).to_string();
+        const uint64_t i = requests.push();
+        requests.set(i, request_layout::id, next_id);
+        requests.set(i, request_layout::sender, checksum160ToAddress(senderAddress()));
+        requests.set(i, request_layout::amount, uint256_t(1 + next_id % 1000) * POW10[EVM_DECIMALS]);
+        requests.set(i, request_layout::requested_at, 1700000000 + next_id);
+        requests.setString(i, request_layout::antelope_token, TOKEN.to_string());
+        requests.setString(i, request_layout::antelope_symbol, symbol);
+        requests.setString(i, request_layout::receiver, "receiver1234");
+        requests.set(i, request_layout::evm_decimals, EVM_DECIMALS);
+
+        const uint64_t j = refunds.push();
+        refunds.set(j, refund_layout::id, next_id);
+        refunds.set(j, refund_layout::amount, uint256_t(1 + next_id % 1000) * POW10[EVM_DECIMALS]);
+        refunds.setString(j, refund_layout::antelope_token, TOKEN.to_string());
+        refunds.setString(j, refund_layout::antelope_symbol, symbol);
+        refunds.setString(j, refund_layout::receiver, "receiver1234");
+        refunds.set(j, refund_layout::evm_decimals, EVM_DECIMALS);
+      }
+      // The TokenBridge id counters, the next ids requests & refunds get
+      bridge.set(toChecksum256(STORAGE_BRIDGE_REQUEST_ID_INDEX), next_id);
+      bridge.set(toChecksum256(STORAGE_BRIDGE_REFUND_ID_INDEX), next_id);
+    }
+
+    // Deploys a new TokenBridge, its ids starting over at 0, & points the contract at it with setevmctc
+    void redeployBridge()
+    {
+      const eosio::checksum160 address = addressToChecksum160(uint256_t(0xb10000 + bridge_scope));
+      bridge_scope = createEvmAccount(address, eosio::name()).index;
+      bridge = evm_storage(bridge_scope);
+      next_id = 0;
+      contract().setevmctc(address, registerAddress());
+    }
+
+    // PairBridgeRegister.removePair of the pair at `i`: the last pair takes its place in pairs[] & in the indexes
+    void removePair(uint64_t i)
+    {
+      const uint64_t last = pairs.length() - 1;
+      registry.set(getMappingSlot(pairs.get(i, pair_layout::id), STORAGE_REGISTER_PAIR_BY_ID_INDEX), 0);
+      registry.set(getMappingSlot(pairs.get(i, pair_layout::evm_address), STORAGE_REGISTER_PAIR_BY_TOKEN_INDEX), 0);
+      if (i != last) {
+        registry.set(getMappingSlot(pairs.get(last, pair_layout::id), STORAGE_REGISTER_PAIR_BY_ID_INDEX), i + 1);
+        registry.set(getMappingSlot(pairs.get(last, pair_layout::evm_address), STORAGE_REGISTER_PAIR_BY_TOKEN_INDEX), i + 1);
+      }
+      pairs.swapAndPop(i);
+    }
+
+    // Runs the EVM side of the raw calls the contract sent: TokenBridge removes the settled requests & refunds
+    void settle(const std::vector<eosio::native::sent_action>& actions)
+    {
+      for (const auto& sent : actions) {
+        if (!isRawCall(sent)) continue;
+        eosio::check(rawNonce(sent) == evmNonce(SELF), "Raw transaction nonce is not the EVM account nonce");
+        incrementNonce(SELF);
+
+        const std::vector<uint8_t> calldata = rawCalldata(sent);
+        if (std::equal(EVM_SUCCESS_CALLBACKS_SIGNATURE.begin(), EVM_SUCCESS_CALLBACKS_SIGNATURE.end(), calldata.begin())) {
+          for (const uint256_t& id : idsArgument(calldata)) requests.swapAndPop(requests.find(request_layout::id, id));
+        } else if (std::equal(EVM_REFUND_CALLBACKS_SIGNATURE.begin(), EVM_REFUND_CALLBACKS_SIGNATURE.end(), calldata.begin())) {
+          for (const uint256_t& id : idsArgument(calldata)) refunds.swapAndPop(refunds.find(refund_layout::id, id));
+        }
+      }
+    }
+
+    private:
+      // The uint[] argument of a single argument call: its offset, then its length & words
+      static std::vector<uint256_t> idsArgument(const std::vector<uint8_t>& calldata)
+      {
+        std::array<uint8_t, 32u> word = {};
+        const auto wordAt = [&](size_t offset) {
+          memcpy(word.data(), calldata.data() + 4 + offset, word.size());
+          return bytesToValue(word);
+        };
+        const size_t start = static_cast<size_t>(wordAt(0));
+        const size_t count = static_cast<size_t>(wordAt(start));
+        std::vector<uint256_t> ids;
+        for (size_t i = 0; i < count; i++) ids.push_back(wordAt(start + WORD_SIZE * (i + 1)));
+        return ids;
+      }
+
+      // Fresh host with eosio.evm set up, returns the TokenBridge account index (PairBridgeRegister's is the next one)
+      static uint64_t deploy()
+      {
+        reset(eosio::time_point(eosio::seconds(1700000000)));
+        setEvmConfig(uint256_t(500000000000ULL));
+        createEvmAccount(selfAddress(), SELF);
+        const uint64_t bridge_scope = createEvmAccount(bridgeAddress(), eosio::name()).index;
+        createEvmAccount(registerAddress(), eosio::name());
+        return bridge_scope;
+      }
+  };
+} // namespace emulator
@@ -0,0 +1,234 @@
+// In memory eosio.evm & eosio.token state for running the contract natively
+// Tables live on the eosio shim host (native/eosio/host.hpp), which counts every host call the actions make
+#pragma once
+
+#include <token.brdg.hpp>
+
+#include <chrono>
+#include <functional>
+#include <string>
+
+namespace emulator
+{
+  using namespace evm_bridge;
+
+  /**
+   * Drops every table, sent action & counter, and sets the block time
+   */
+  inline void reset(eosio::time_point now = eosio::time_point())
+  {
+    eosio::native::host() = eosio::native::host_state();
+    eosio::native::host().now = now;
+  }
+
+  struct measurement {
+    eosio::native::host_counters counters;
+    std::vector<eosio::native::sent_action> actions;
+    uint64_t ns;
+  };
+
+  // Runs one action with fresh counters & sent actions, the way a node would bill a single transaction
+  inline measurement measure(const std::function<void()>& action)
+  {
+    auto& h = eosio::native::host();
+    h.counters = eosio::native::host_counters();
+    h.actions.clear();
+    const auto start = std::chrono::steady_clock::now();
+    action();
+    const uint64_t elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+    return measurement { h.counters, std::move(h.actions), elapsed };
+  }
+
+  //======================== eosio.evm ========================
+
+  inline const Account& createEvmAccount(const eosio::checksum160& address, eosio::name account, uint64_t nonce = 0)
+  {
+    account_table accounts(EVM_SYSTEM_CONTRACT, EVM_SYSTEM_CONTRACT.value);
+    return *accounts.emplace(EVM_SYSTEM_CONTRACT, [&](auto& a) {
+      a.index = accounts.available_primary_key();
+      a.address = address;
+      a.account = account;
+      a.nonce = nonce;
+      a.balance = 0;
+    });
+  }
+
+  // eosio.evm bumps the sender nonce of every raw transaction it runs
+  inline void incrementNonce(eosio::name account)
+  {
+    account_table accounts(EVM_SYSTEM_CONTRACT, EVM_SYSTEM_CONTRACT.value);
+    auto by_account = accounts.get_index<"byaccount"_n>();
+    by_account.modify(by_account.require_find(account.value, "EVM account not found"), EVM_SYSTEM_CONTRACT, [](auto& a) {
+      a.nonce++;
+    });
+  }
+
+  inline uint64_t evmNonce(eosio::name account)
+  {
+    account_table accounts(EVM_SYSTEM_CONTRACT, EVM_SYSTEM_CONTRACT.value);
+    auto by_account = accounts.get_index<"byaccount"_n>();
+    return by_account.require_find(account.value, "EVM account not found")->nonce;
+  }
+
+  inline void setEvmConfig(const uint256_t& gas_price)
+  {
+    config_singleton_evm config(EVM_SYSTEM_CONTRACT, EVM_SYSTEM_CONTRACT.value);
+    auto row = config.get_or_default();
+    row.gas_price = gas_price;
+    config.set(row, EVM_SYSTEM_CONTRACT);
+  }
+
+  /**
+   * Storage of one EVM contract, kept in accountstate rows scoped by its account index
+   * Zero words have no row, as on eosio.evm
+   */
+  class evm_storage {
+    public:
+      explicit evm_storage(uint64_t scope) : states(EVM_SYSTEM_CONTRACT, scope) {}
+
+      uint256_t get(const eosio::checksum256& key) const
+      {
+        auto by_key = states.get_index<"bykey"_n>();
+        const auto row = by_key.find(key);
+        return row != by_key.end() ? row->value : uint256_t(0);
+      }
+
+      void set(const eosio::checksum256& key, const uint256_t& value)
+      {
+        auto by_key = states.get_index<"bykey"_n>();
+        const auto row = by_key.find(key);
+        if (row == by_key.end()) {
+          if (value == 0) return;
+          states.emplace(EVM_SYSTEM_CONTRACT, [&](auto& s) {
+            s.index = states.available_primary_key();
+            s.key = key;
+            s.value = value;
+          });
+        } else if (value == 0) {
+          by_key.erase(row);
+        } else {
+          by_key.modify(row, EVM_SYSTEM_CONTRACT, [&](auto& s) { s.value = value; });
+        }
+      }
+
+      void set(const uint256_t& slot, const uint256_t& value) { set(toChecksum256(slot), value); }
+
+      // Solidity string layout: short strings left aligned with length * 2 in the last byte,
+      // longer ones keep length * 2 + 1 in the slot & their bytes from keccak256(slot) onwards
+      void setString(const eosio::checksum256& key, const std::string& value)
+      {
+        std::array<uint8_t, 32u> word = {};
+        if (value.size() < WORD_SIZE) {
+          memcpy(word.data(), value.data(), value.size());
+          word[31] = uint8_t(value.size() * 2);
+          set(key, bytesToValue(word));
+          return;
+        }
+        set(key, uint256_t(value.size() * 2 + 1));
+        const uint256_t data_slot = bytesToValue(keccak_256(key.extract_as_byte_array()));
+        for (size_t offset = 0; offset < value.size(); offset += WORD_SIZE) {
+          word = {};
+          memcpy(word.data(), value.data() + offset, std::min<size_t>(WORD_SIZE, value.size() - offset));
+          set(data_slot + offset / WORD_SIZE, bytesToValue(word));
+        }
+      }
+
+    private:
+      mutable account_state_table states;
+  };
+
+  /**
+   * A dynamic array of structs (Request[], Refund[], Pair[]...) in an EVM contract storage, laid out after `Layout`
+   * Members are written as whole slots, none of the bridge structs pack two members in one
+   */
+  template <typename Layout>
+  class evm_array {
+    public:
+      evm_array(evm_storage& storage, uint8_t storage_index)
+        : storage(storage), storage_index(storage_index), base(bytesToValue(arrayBaseSlot(storage_index))) {}
+
+      uint64_t length() const { return static_cast<uint64_t>(storage.get(toChecksum256(storage_index))); }
+
+      uint256_t get(uint64_t i, uint8_t member) const { return storage.get(slot(i, member)); }
+
+      void set(uint64_t i, uint8_t member, const uint256_t& value) { storage.set(slot(i, member), value); }
+
+      void setString(uint64_t i, uint8_t member, const std::string& value) { storage.setString(slot(i, member), value); }
+
+      // Appends an element, the caller then sets its properties
+      uint64_t push()
+      {
+        const uint64_t i = length();
+        storage.set(toChecksum256(storage_index), uint256_t(i + 1));
+        return i;
+      }
+
+      // Solidity's array[i] = array[length - 1]; array.pop(), for structs of value & short string properties
+      void swapAndPop(uint64_t i)
+      {
+        const uint64_t last = length() - 1;
+        for (uint8_t s = 0; s < Layout::slot_count; s++) {
+          const eosio::checksum256 to = getArrayMemberSlot(base, s, Layout::slot_count, i);
+          const eosio::checksum256 from = getArrayMemberSlot(base, s, Layout::slot_count, last);
+          if (i != last) storage.set(to, storage.get(from));
+          storage.set(from, 0);
+        }
+        storage.set(toChecksum256(storage_index), uint256_t(last));
+      }
+
+      // Index of the element whose `member` equals `value`, or length() if there is none
+      uint64_t find(uint8_t member, const uint256_t& value) const
+      {
+        const uint64_t count = length();
+        for (uint64_t i = 0; i < count; i++) {
+          if (get(i, member) == value) return i;
+        }
+        return count;
+      }
+
+    private:
+      eosio::checksum256 slot(uint64_t i, uint8_t member) const { return getStructMemberSlot<Layout>(base, member, i); }
+
+      evm_storage& storage;
+      uint8_t storage_index;
+      uint256_t base;
+  };
+
+  //======================== eosio.token ========================
+
+  inline void createToken(eosio::name contract, const eosio::asset& max_supply, eosio::name issuer)
+  {
+    eosio_tokens stats(contract, max_supply.symbol.code().raw());
+    stats.emplace(contract, [&](auto& s) {
+      s.supply = eosio::asset(0, max_supply.symbol);
+      s.max_supply = max_supply;
+      s.issuer = issuer;
+    });
+  }
+
+  //======================== Sent actions ========================
+
+  // Calldata of an eosio.evm raw action sent by the contract
+  inline std::vector<uint8_t> rawCalldata(const eosio::native::sent_action& sent)
+  {
+    const auto raw = eosio::unpack<std::tuple<eosio::name, std::vector<int8_t>, bool, std::optional<eosio::checksum160>>>(sent.data);
+    const auto tx = rlp::decode(std::get<1>(raw));
+    eosio::check(tx.values.size() == 9, "Raw transaction is not a legacy transaction");
+    return std::vector<uint8_t>(tx.values[5].value.begin(), tx.values[5].value.end());
+  }
+
+  // Nonce of a raw call's transaction, big endian with no leading zero bytes
+  inline uint64_t rawNonce(const eosio::native::sent_action& sent)
+  {
+    const auto raw = eosio::unpack<std::tuple<eosio::name, std::vector<int8_t>, bool, std::optional<eosio::checksum160>>>(sent.data);
+    const auto tx = rlp::decode(std::get<1>(raw));
+    uint64_t nonce = 0;
+    for (const unsigned char byte : tx.values[0].value) nonce = (nonce << 8) | byte;
+    return nonce;
+  }
+
+  inline bool isRawCall(const eosio::native::sent_action& sent)
+  {
+    return sent.account == EVM_SYSTEM_CONTRACT && sent.action_name == "raw"_n;
+  }
+} // namespace emulator
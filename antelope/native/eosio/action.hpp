@@ -0,0 +1,58 @@
+// Native stand-in for <eosio/action.hpp>, sent actions are recorded on the host instead of dispatched
+#pragma once
+
+#include <eosio/datastream.hpp>
+#include <eosio/host.hpp>
+#include <eosio/name.hpp>
+
+#include <utility>
+#include <vector>
+
+namespace eosio {
+   struct permission_level {
+      permission_level(name a, name p) : actor(a), permission(p) {}
+      permission_level() {}
+
+      name actor;
+      name permission;
+
+      friend bool operator==(const permission_level& a, const permission_level& b) {
+         return a.actor == b.actor && a.permission == b.permission;
+      }
+
+      EOSLIB_SERIALIZE(permission_level, (actor)(permission))
+   };
+
+   struct action {
+      eosio::name account;
+      eosio::name name;
+      std::vector<permission_level> authorization;
+      std::vector<char> data;
+
+      action() = default;
+
+      template <typename T>
+      action(const permission_level& auth, eosio::name a, eosio::name n, T&& value)
+         : account(a), name(n), authorization(1, auth), data(pack(std::forward<T>(value))) {}
+
+      template <typename T>
+      action(std::vector<permission_level> auths, eosio::name a, eosio::name n, T&& value)
+         : account(a), name(n), authorization(std::move(auths)), data(pack(std::forward<T>(value))) {}
+
+      void send() const {
+         auto& h = native::host();
+         native::sent_action sent{account, name, {}, data};
+         for (const auto& auth : authorization) {
+            sent.authorization.emplace_back(auth.actor, auth.permission);
+         }
+         h.actions.push_back(std::move(sent));
+         h.counters.inline_actions++;
+         h.counters.inline_bytes += data.size();
+      }
+
+      template <typename T>
+      T data_as() const {
+         return unpack<T>(data);
+      }
+   };
+}
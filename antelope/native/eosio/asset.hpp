@@ -0,0 +1,47 @@
+// Native stand-in for <eosio/asset.hpp>
+#pragma once
+
+#include <eosio/check.hpp>
+#include <eosio/symbol.hpp>
+
+#include <cstdint>
+#include <string>
+
+namespace eosio {
+   /**
+    * Signed amount of a given symbol
+    */
+   struct asset {
+      static constexpr int64_t max_amount = (1LL << 62) - 1;
+
+      int64_t amount = 0;
+      eosio::symbol symbol;
+
+      asset() {}
+
+      asset(int64_t a, eosio::symbol s) : amount(a), symbol{s} {
+         check(is_amount_within_range(), "magnitude of asset amount must be less than 2^62");
+         check(symbol.is_valid(), "invalid symbol name");
+      }
+
+      bool is_amount_within_range() const { return -max_amount <= amount && amount <= max_amount; }
+      bool is_valid() const { return is_amount_within_range() && symbol.is_valid(); }
+
+      std::string to_string() const {
+         const uint8_t precision = symbol.precision();
+         const bool negative = amount < 0;
+         uint64_t abs = negative ? -amount : amount;
+         std::string digits = std::to_string(abs);
+         if (precision > 0) {
+            if (digits.size() <= precision) {
+               digits.insert(0, precision + 1 - digits.size(), '0');
+            }
+            digits.insert(digits.size() - precision, 1, '.');
+         }
+         return (negative ? "-" : "") + digits + " " + symbol.code().to_string();
+      }
+
+      friend bool operator==(const asset& a, const asset& b) { return a.amount == b.amount && a.symbol == b.symbol; }
+      friend bool operator!=(const asset& a, const asset& b) { return !(a == b); }
+   };
+}
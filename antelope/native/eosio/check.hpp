@@ -0,0 +1,32 @@
+// Native stand-in for <eosio/check.hpp>
+#pragma once
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+namespace eosio {
+   /**
+    * Thrown in place of eosio_assert so native builds can observe aborted actions
+    */
+   struct eosio_assert_exception : std::runtime_error {
+      using std::runtime_error::runtime_error;
+   };
+
+   constexpr inline void check(bool pred, const char* msg) {
+      if (!pred) throw eosio_assert_exception(msg);
+   }
+
+   inline void check(bool pred, const std::string& msg) {
+      if (!pred) throw eosio_assert_exception(msg);
+   }
+
+   inline void check(bool pred, std::string_view msg) {
+      if (!pred) throw eosio_assert_exception(std::string(msg));
+   }
+
+   constexpr inline void check(bool pred, uint64_t code) {
+      if (!pred) throw eosio_assert_exception("assertion failure with error code: " + std::to_string(code));
+   }
+}
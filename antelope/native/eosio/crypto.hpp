@@ -0,0 +1,4 @@
+// Native stand-in for <eosio/crypto.hpp>
+#pragma once
+
+#include <eosio/fixed_bytes.hpp>
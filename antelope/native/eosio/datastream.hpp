@@ -0,0 +1,345 @@
+// Native stand-in for <eosio/datastream.hpp> and <eosio/serialize.hpp>
+#pragma once
+
+#include <eosio/asset.hpp>
+#include <eosio/check.hpp>
+#include <eosio/fixed_bytes.hpp>
+#include <eosio/name.hpp>
+#include <eosio/symbol.hpp>
+#include <eosio/time.hpp>
+
+#include <boost/preprocessor/seq/for_each.hpp>
+
+#include <array>
+#include <cstring>
+#include <map>
+#include <optional>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace eosio {
+   /**
+    * Byte cursor over a caller-owned buffer
+    */
+   template <typename T>
+   class datastream {
+   public:
+      datastream(T start, size_t s) : _start(start), _pos(start), _end(start + s) {}
+
+      inline void skip(size_t s) { _pos += s; }
+
+      inline bool read(char* d, size_t s) {
+         check(size_t(_end - _pos) >= s, "datastream attempted to read past the end");
+         std::memcpy(d, _pos, s);
+         _pos += s;
+         return true;
+      }
+
+      inline bool write(const char* d, size_t s) {
+         check(_end - _pos >= (int32_t)s, "datastream attempted to write past the end");
+         std::memcpy((void*)_pos, d, s);
+         _pos += s;
+         return true;
+      }
+
+      inline bool write(char d) { return write(&d, 1); }
+
+      T pos() const { return _pos; }
+      inline bool valid() const { return _pos <= _end && _pos >= _start; }
+      inline bool seekp(size_t p) { _pos = _start + p; return _pos <= _end; }
+      inline size_t tellp() const { return size_t(_pos - _start); }
+      inline size_t remaining() const { return _end - _pos; }
+
+   private:
+      T _start;
+      T _pos;
+      T _end;
+   };
+
+   /**
+    * Size-only stream used by pack_size
+    */
+   template <>
+   class datastream<size_t> {
+   public:
+      datastream(size_t init_size = 0) : _size(init_size) {}
+
+      inline bool skip(size_t s) { _size += s; return true; }
+      inline bool write(const char*, size_t s) { _size += s; return true; }
+      inline bool write(char) { _size++; return true; }
+      inline bool valid() const { return true; }
+      inline bool seekp(size_t p) { _size = p; return true; }
+      inline size_t tellp() const { return _size; }
+      inline size_t remaining() const { return 0; }
+
+   private:
+      size_t _size;
+   };
+
+   struct unsigned_int {
+      unsigned_int(uint32_t v = 0) : value(v) {}
+      operator uint32_t() const { return value; }
+
+      uint32_t value;
+   };
+
+   template <typename Stream>
+   inline datastream<Stream>& operator<<(datastream<Stream>& ds, const unsigned_int& v) {
+      uint64_t val = v.value;
+      do {
+         uint8_t b = uint8_t(val) & 0x7f;
+         val >>= 7;
+         b |= ((val > 0) << 7);
+         ds.write((char)b);
+      } while (val);
+      return ds;
+   }
+
+   template <typename Stream>
+   inline datastream<Stream>& operator>>(datastream<Stream>& ds, unsigned_int& vi) {
+      uint64_t v = 0;
+      char b = 0;
+      uint8_t by = 0;
+      do {
+         ds.read(&b, 1);
+         v |= uint32_t(uint8_t(b) & 0x7f) << by;
+         by += 7;
+      } while (uint8_t(b) & 0x80);
+      vi.value = static_cast<uint32_t>(v);
+      return ds;
+   }
+
+   template <typename Stream, typename T, std::enable_if_t<std::is_arithmetic<T>::value || std::is_enum<T>::value>* = nullptr>
+   inline datastream<Stream>& operator<<(datastream<Stream>& ds, const T& v) {
+      ds.write((const char*)&v, sizeof(T));
+      return ds;
+   }
+
+   template <typename Stream, typename T, std::enable_if_t<std::is_arithmetic<T>::value || std::is_enum<T>::value>* = nullptr>
+   inline datastream<Stream>& operator>>(datastream<Stream>& ds, T& v) {
+      ds.read((char*)&v, sizeof(T));
+      return ds;
+   }
+
+   template <typename Stream>
+   inline datastream<Stream>& operator<<(datastream<Stream>& ds, const std::string& v) {
+      ds << unsigned_int(v.size());
+      if (v.size()) ds.write(v.data(), v.size());
+      return ds;
+   }
+
+   template <typename Stream>
+   inline datastream<Stream>& operator>>(datastream<Stream>& ds, std::string& v) {
+      unsigned_int s;
+      ds >> s;
+      v.resize(s.value);
+      if (s.value) ds.read(v.data(), s.value);
+      return ds;
+   }
+
+   template <typename Stream, typename T, std::size_t N>
+   inline datastream<Stream>& operator<<(datastream<Stream>& ds, const std::array<T, N>& v) {
+      if constexpr (std::is_same<T, uint8_t>::value || std::is_same<T, char>::value) {
+         ds.write((const char*)v.data(), N);
+      } else {
+         for (const auto& i : v) ds << i;
+      }
+      return ds;
+   }
+
+   template <typename Stream, typename T, std::size_t N>
+   inline datastream<Stream>& operator>>(datastream<Stream>& ds, std::array<T, N>& v) {
+      if constexpr (std::is_same<T, uint8_t>::value || std::is_same<T, char>::value) {
+         ds.read((char*)v.data(), N);
+      } else {
+         for (auto& i : v) ds >> i;
+      }
+      return ds;
+   }
+
+   template <typename Stream, typename T>
+   inline datastream<Stream>& operator<<(datastream<Stream>& ds, const std::vector<T>& v) {
+      ds << unsigned_int(v.size());
+      if constexpr (std::is_same<T, uint8_t>::value || std::is_same<T, char>::value || std::is_same<T, int8_t>::value) {
+         if (v.size()) ds.write((const char*)v.data(), v.size());
+      } else {
+         for (const auto& i : v) ds << i;
+      }
+      return ds;
+   }
+
+   template <typename Stream, typename T>
+   inline datastream<Stream>& operator>>(datastream<Stream>& ds, std::vector<T>& v) {
+      unsigned_int s;
+      ds >> s;
+      v.resize(s.value);
+      if constexpr (std::is_same<T, uint8_t>::value || std::is_same<T, char>::value || std::is_same<T, int8_t>::value) {
+         if (s.value) ds.read((char*)v.data(), s.value);
+      } else {
+         for (auto& i : v) ds >> i;
+      }
+      return ds;
+   }
+
+   template <typename Stream, typename K, typename V>
+   inline datastream<Stream>& operator<<(datastream<Stream>& ds, const std::map<K, V>& m) {
+      ds << unsigned_int(m.size());
+      for (const auto& i : m) ds << i.first << i.second;
+      return ds;
+   }
+
+   template <typename Stream, typename K, typename V>
+   inline datastream<Stream>& operator>>(datastream<Stream>& ds, std::map<K, V>& m) {
+      unsigned_int s;
+      ds >> s;
+      m.clear();
+      for (uint32_t i = 0; i < s.value; ++i) {
+         K k;
+         V v;
+         ds >> k >> v;
+         m.emplace(std::move(k), std::move(v));
+      }
+      return ds;
+   }
+
+   template <typename Stream, typename T>
+   inline datastream<Stream>& operator<<(datastream<Stream>& ds, const std::optional<T>& opt) {
+      char valid = opt.has_value();
+      ds << valid;
+      if (valid) ds << *opt;
+      return ds;
+   }
+
+   template <typename Stream, typename T>
+   inline datastream<Stream>& operator>>(datastream<Stream>& ds, std::optional<T>& opt) {
+      char valid = 0;
+      ds >> valid;
+      if (valid) {
+         T val;
+         ds >> val;
+         opt = val;
+      } else {
+         opt.reset();
+      }
+      return ds;
+   }
+
+   template <typename Stream, typename... Args>
+   inline datastream<Stream>& operator<<(datastream<Stream>& ds, const std::tuple<Args...>& t) {
+      std::apply([&ds](const auto&... args) { ((ds << args), ...); }, t);
+      return ds;
+   }
+
+   template <typename Stream, typename... Args>
+   inline datastream<Stream>& operator>>(datastream<Stream>& ds, std::tuple<Args...>& t) {
+      std::apply([&ds](auto&... args) { ((ds >> args), ...); }, t);
+      return ds;
+   }
+
+   template <typename Stream, typename A, typename B>
+   inline datastream<Stream>& operator<<(datastream<Stream>& ds, const std::pair<A, B>& p) {
+      return ds << p.first << p.second;
+   }
+
+   template <typename Stream, typename A, typename B>
+   inline datastream<Stream>& operator>>(datastream<Stream>& ds, std::pair<A, B>& p) {
+      return ds >> p.first >> p.second;
+   }
+
+   template <typename Stream>
+   inline datastream<Stream>& operator<<(datastream<Stream>& ds, const name& v) { return ds << v.value; }
+   template <typename Stream>
+   inline datastream<Stream>& operator>>(datastream<Stream>& ds, name& v) { return ds >> v.value; }
+
+   template <typename Stream>
+   inline datastream<Stream>& operator<<(datastream<Stream>& ds, const symbol_code& v) { return ds << v.raw(); }
+   template <typename Stream>
+   inline datastream<Stream>& operator>>(datastream<Stream>& ds, symbol_code& v) {
+      uint64_t raw = 0;
+      ds >> raw;
+      v = symbol_code(raw);
+      return ds;
+   }
+
+   template <typename Stream>
+   inline datastream<Stream>& operator<<(datastream<Stream>& ds, const symbol& v) { return ds << v.raw(); }
+   template <typename Stream>
+   inline datastream<Stream>& operator>>(datastream<Stream>& ds, symbol& v) {
+      uint64_t raw = 0;
+      ds >> raw;
+      v = symbol(raw);
+      return ds;
+   }
+
+   template <typename Stream>
+   inline datastream<Stream>& operator<<(datastream<Stream>& ds, const asset& v) { return ds << v.amount << v.symbol; }
+   template <typename Stream>
+   inline datastream<Stream>& operator>>(datastream<Stream>& ds, asset& v) { return ds >> v.amount >> v.symbol; }
+
+   template <typename Stream, size_t Size>
+   inline datastream<Stream>& operator<<(datastream<Stream>& ds, const fixed_bytes<Size>& v) {
+      return ds << v.extract_as_byte_array();
+   }
+   template <typename Stream, size_t Size>
+   inline datastream<Stream>& operator>>(datastream<Stream>& ds, fixed_bytes<Size>& v) {
+      std::array<uint8_t, Size> arr;
+      ds >> arr;
+      v = fixed_bytes<Size>(arr);
+      return ds;
+   }
+
+   template <typename Stream>
+   inline datastream<Stream>& operator<<(datastream<Stream>& ds, const time_point& v) { return ds << v.elapsed._count; }
+   template <typename Stream>
+   inline datastream<Stream>& operator>>(datastream<Stream>& ds, time_point& v) { return ds >> v.elapsed._count; }
+
+   template <typename Stream>
+   inline datastream<Stream>& operator<<(datastream<Stream>& ds, const time_point_sec& v) { return ds << v.utc_seconds; }
+   template <typename Stream>
+   inline datastream<Stream>& operator>>(datastream<Stream>& ds, time_point_sec& v) { return ds >> v.utc_seconds; }
+
+   template <typename T>
+   size_t pack_size(const T& value) {
+      datastream<size_t> ps;
+      ps << value;
+      return ps.tellp();
+   }
+
+   template <typename T>
+   std::vector<char> pack(const T& value) {
+      std::vector<char> result;
+      result.resize(pack_size(value));
+
+      datastream<char*> ds(result.data(), result.size());
+      ds << value;
+      return result;
+   }
+
+   template <typename T>
+   T unpack(const char* buffer, size_t len) {
+      T result;
+      datastream<const char*> ds(buffer, len);
+      ds >> result;
+      return result;
+   }
+
+   template <typename T>
+   T unpack(const std::vector<char>& bytes) {
+      return unpack<T>(bytes.data(), bytes.size());
+   }
+}
+
+#define EOSLIB_REFLECT_MEMBER_OP(r, OP, elem) OP t.elem
+
+#define EOSLIB_SERIALIZE(TYPE, MEMBERS)                                        \
+   template <typename DataStream>                                              \
+   friend DataStream& operator<<(DataStream& ds, const TYPE& t) {              \
+      return ds BOOST_PP_SEQ_FOR_EACH(EOSLIB_REFLECT_MEMBER_OP, <<, MEMBERS);  \
+   }                                                                           \
+   template <typename DataStream>                                              \
+   friend DataStream& operator>>(DataStream& ds, TYPE& t) {                    \
+      return ds BOOST_PP_SEQ_FOR_EACH(EOSLIB_REFLECT_MEMBER_OP, >>, MEMBERS);  \
+   }
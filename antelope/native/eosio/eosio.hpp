@@ -0,0 +1,20 @@
+// Native stand-in for <eosio/eosio.hpp>
+#pragma once
+
+#include <eosio/action.hpp>
+#include <eosio/check.hpp>
+#include <eosio/contract.hpp>
+#include <eosio/datastream.hpp>
+#include <eosio/multi_index.hpp>
+#include <eosio/name.hpp>
+#include <eosio/print.hpp>
+#include <eosio/system.hpp>
+
+// Pulled in transitively by the CDT headers, the vendored intx & rlp rely on them
+#include <algorithm>
+#include <array>
+#include <climits>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <vector>
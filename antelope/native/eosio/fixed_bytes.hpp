@@ -0,0 +1,57 @@
+// Native stand-in for <eosio/fixed_bytes.hpp>
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <climits>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace eosio {
+   /**
+    * Fixed size byte sequence, ordered lexicographically like the on-chain 128-bit word layout
+    */
+   template <size_t Size>
+   class fixed_bytes {
+   public:
+      static constexpr size_t num_bytes = Size;
+
+      constexpr fixed_bytes() : _data{} {}
+
+      constexpr fixed_bytes(const std::array<uint8_t, Size>& arr) : _data(arr) {}
+
+      template <typename Word, size_t NumWords,
+                typename Enable = typename std::enable_if<std::is_integral<Word>::value &&
+                                                          std::is_unsigned<Word>::value &&
+                                                          !std::is_same<Word, bool>::value>::type>
+      fixed_bytes(const std::array<Word, NumWords>& arr) : _data{} {
+         static_assert(sizeof(Word) * NumWords <= Size, "too many words supplied to fixed_bytes constructor");
+         size_t pos = 0;
+         for (const auto w : arr) {
+            for (size_t b = sizeof(Word); b > 0; --b) {
+               _data[pos++] = static_cast<uint8_t>(w >> (8 * (b - 1)));
+            }
+         }
+      }
+
+      constexpr std::array<uint8_t, Size> extract_as_byte_array() const { return _data; }
+
+      const uint8_t* data() const { return _data.data(); }
+      constexpr size_t size() const { return Size; }
+
+      friend bool operator==(const fixed_bytes& a, const fixed_bytes& b) { return a._data == b._data; }
+      friend bool operator!=(const fixed_bytes& a, const fixed_bytes& b) { return a._data != b._data; }
+      friend bool operator<(const fixed_bytes& a, const fixed_bytes& b) { return a._data < b._data; }
+      friend bool operator>(const fixed_bytes& a, const fixed_bytes& b) { return a._data > b._data; }
+      friend bool operator<=(const fixed_bytes& a, const fixed_bytes& b) { return a._data <= b._data; }
+      friend bool operator>=(const fixed_bytes& a, const fixed_bytes& b) { return a._data >= b._data; }
+
+   private:
+      std::array<uint8_t, Size> _data;
+   };
+
+   using checksum160 = fixed_bytes<20>;
+   using checksum256 = fixed_bytes<32>;
+   using checksum512 = fixed_bytes<64>;
+}
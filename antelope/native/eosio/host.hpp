@@ -0,0 +1,73 @@
+// Host state backing the native eosio shim: clock, authorizations, tables and sent actions
+#pragma once
+
+#include <eosio/name.hpp>
+#include <eosio/time.hpp>
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <set>
+#include <tuple>
+#include <vector>
+
+namespace eosio {
+   struct permission_level;
+
+   namespace native {
+      /**
+       * Host calls performed since the last reset, grouped the way the chain bills them
+       */
+      struct host_counters {
+         uint64_t db_find        = 0; // db_find_i64
+         uint64_t db_lowerbound  = 0; // db_lowerbound_i64
+         uint64_t db_upperbound  = 0; // db_upperbound_i64
+         uint64_t db_next        = 0; // db_next_i64
+         uint64_t db_previous    = 0; // db_previous_i64 / db_end_i64
+         uint64_t db_get         = 0; // db_get_i64, row loaded into the multi_index cache
+         uint64_t db_store       = 0; // db_store_i64 and db_idx*_store
+         uint64_t db_update      = 0; // db_update_i64 and db_idx*_update
+         uint64_t db_remove      = 0; // db_remove_i64 and db_idx*_remove
+         uint64_t idx_find       = 0; // db_idx*_find_secondary
+         uint64_t idx_lowerbound = 0; // db_idx*_lowerbound
+         uint64_t idx_upperbound = 0; // db_idx*_upperbound
+         uint64_t idx_next       = 0; // db_idx*_next
+         uint64_t idx_previous   = 0; // db_idx*_previous / db_idx*_end
+         uint64_t storage_seeks  = 0; // the idx_find & idx_lowerbound of them on eosio.evm accountstate, EVM Storage reads that are not a step
+         uint64_t bytes_read     = 0; // bytes deserialized out of rows
+         uint64_t bytes_written  = 0; // bytes serialized into rows
+         uint64_t inline_actions = 0; // send_inline
+         uint64_t inline_bytes   = 0; // serialized inline action data
+
+         uint64_t db_reads() const {
+            return db_find + db_lowerbound + db_upperbound + db_next + db_previous +
+                   idx_find + idx_lowerbound + idx_upperbound + idx_next + idx_previous;
+         }
+         uint64_t db_writes() const { return db_store + db_update + db_remove; }
+         uint64_t idx_searches() const { return idx_find + idx_lowerbound + idx_upperbound; } // the reads walking the index tree
+      };
+
+      struct sent_action {
+         name account;
+         name action_name;
+         std::vector<std::pair<name, name>> authorization;
+         std::vector<char> data;
+      };
+
+      struct host_state {
+         host_counters counters;
+         std::vector<sent_action> actions;
+         time_point now;
+         std::set<uint64_t> auths;          // empty means every authority is satisfied
+         std::set<uint64_t> missing_accounts;
+         std::map<std::tuple<uint64_t, uint64_t, uint64_t>, std::shared_ptr<void>> tables;
+      };
+
+      inline host_state& host() {
+         static host_state state;
+         return state;
+      }
+
+      inline host_counters& counters() { return host().counters; }
+   }
+}
@@ -0,0 +1,465 @@
+// Native stand-in for <eosio/multi_index.hpp>
+// Rows live in the shared host state so every instance on the same code/scope/table sees the same
+// data, and each operation is counted as the host call(s) the on-chain multi_index would make.
+#pragma once
+
+#include <eosio/check.hpp>
+#include <eosio/datastream.hpp>
+#include <eosio/host.hpp>
+#include <eosio/name.hpp>
+
+#include <iterator>
+#include <limits>
+#include <map>
+#include <memory>
+#include <set>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace eosio {
+   template <name::raw IndexName, typename Extractor>
+   struct indexed_by {
+      enum constants { index_name = static_cast<uint64_t>(IndexName) };
+      typedef Extractor secondary_extractor_type;
+   };
+
+   template <class Class, typename Type, Type (Class::*PtrToMemberFunction)() const>
+   struct const_mem_fun {
+      typedef typename std::remove_cv<typename std::remove_reference<Type>::type>::type result_type;
+
+      template <typename ChainedPtr>
+      result_type operator()(const ChainedPtr& x) const { return (x.*PtrToMemberFunction)(); }
+   };
+
+   namespace native {
+      template <typename T, typename = void>
+      struct is_packable : std::false_type {};
+
+      template <typename T>
+      struct is_packable<T, std::void_t<decltype(std::declval<datastream<size_t>&>() << std::declval<const T&>())>>
+         : std::true_type {};
+
+      // Serialized size of a row, tables declared without EOSLIB_SERIALIZE fall back to their in-memory size
+      template <typename T>
+      size_t row_size(const T& obj) {
+         if constexpr (is_packable<T>::value) {
+            return pack_size(obj);
+         } else {
+            return sizeof(T);
+         }
+      }
+
+      template <typename T, typename... Indices>
+      struct table_data {
+         std::map<uint64_t, T> rows;
+         std::tuple<std::set<std::pair<typename Indices::secondary_extractor_type::result_type, uint64_t>>...> indices;
+
+         template <size_t... Is>
+         void insert_secondaries(const T& obj, uint64_t pk, std::index_sequence<Is...>) {
+            (std::get<Is>(indices).emplace(
+                typename std::tuple_element<Is, std::tuple<Indices...>>::type::secondary_extractor_type{}(obj), pk), ...);
+         }
+
+         template <size_t... Is>
+         void erase_secondaries(const T& obj, uint64_t pk, std::index_sequence<Is...>) {
+            (std::get<Is>(indices).erase(std::make_pair(
+                typename std::tuple_element<Is, std::tuple<Indices...>>::type::secondary_extractor_type{}(obj), pk)), ...);
+         }
+
+         void insert_secondaries(const T& obj, uint64_t pk) { insert_secondaries(obj, pk, std::index_sequence_for<Indices...>{}); }
+         void erase_secondaries(const T& obj, uint64_t pk) { erase_secondaries(obj, pk, std::index_sequence_for<Indices...>{}); }
+      };
+
+      template <typename Data>
+      Data& open_table(uint64_t code, uint64_t scope, uint64_t table) {
+         auto& slot = host().tables[std::make_tuple(code, scope, table)];
+         if (!slot) {
+            slot = std::make_shared<Data>();
+         }
+         return *std::static_pointer_cast<Data>(slot);
+      }
+
+      template <uint64_t Name, typename... Indices>
+      constexpr size_t index_position() {
+         constexpr uint64_t names[] = {static_cast<uint64_t>(Indices::index_name)..., Name};
+         for (size_t i = 0; i < sizeof...(Indices); ++i) {
+            if (names[i] == Name) return i;
+         }
+         return sizeof...(Indices);
+      }
+   }
+
+   template <name::raw TableName, typename T, typename... Indices>
+   class multi_index {
+   private:
+      static_assert(sizeof...(Indices) <= 16, "multi_index only supports a maximum of 16 secondary indices");
+
+      using data_type = native::table_data<T, Indices...>;
+      using row_iterator = typename std::map<uint64_t, T>::const_iterator;
+
+      static constexpr uint64_t unset_next_primary_key = std::numeric_limits<uint64_t>::max() - 1;
+      static constexpr uint64_t no_available_primary_key = std::numeric_limits<uint64_t>::max() - 2;
+
+      name _code;
+      uint64_t _scope;
+      data_type* _data;
+      mutable uint64_t _next_primary_key = unset_next_primary_key;
+      mutable std::set<uint64_t> _loaded;
+
+      // First access of a row in this instance deserializes it, like the on-chain item cache
+      void load(row_iterator it) const {
+         if (it != _data->rows.end() && _loaded.insert(it->first).second) {
+            auto& c = native::counters();
+            c.db_get++;
+            c.bytes_read += native::row_size(it->second);
+         }
+      }
+
+   public:
+      class const_iterator {
+      public:
+         using iterator_category = std::bidirectional_iterator_tag;
+         using value_type = const T;
+         using difference_type = std::ptrdiff_t;
+         using pointer = const T*;
+         using reference = const T&;
+
+         const_iterator() = default;
+
+         const T& operator*() const {
+            check(_it != _multidx->_data->rows.end(), "cannot dereference end iterator");
+            return _it->second;
+         }
+         const T* operator->() const { return &operator*(); }
+
+         const_iterator operator++(int) { const_iterator result(*this); ++(*this); return result; }
+         const_iterator operator--(int) { const_iterator result(*this); --(*this); return result; }
+
+         const_iterator& operator++() {
+            check(_it != _multidx->_data->rows.end(), "cannot increment end iterator");
+            native::counters().db_next++;
+            ++_it;
+            _multidx->load(_it);
+            return *this;
+         }
+
+         const_iterator& operator--() {
+            check(_it != _multidx->_data->rows.begin(), "cannot decrement iterator at beginning of table");
+            native::counters().db_previous++;
+            --_it;
+            _multidx->load(_it);
+            return *this;
+         }
+
+         friend bool operator==(const const_iterator& a, const const_iterator& b) { return a._it == b._it; }
+         friend bool operator!=(const const_iterator& a, const const_iterator& b) { return a._it != b._it; }
+
+      private:
+         friend class multi_index;
+         const_iterator(const multi_index* mi, row_iterator it) : _multidx(mi), _it(it) {}
+
+         const multi_index* _multidx = nullptr;
+         row_iterator _it;
+      };
+
+      typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+
+      template <size_t I>
+      class index {
+      public:
+         using index_type = typename std::tuple_element<I, std::tuple<Indices...>>::type;
+         using extractor_type = typename index_type::secondary_extractor_type;
+         using secondary_key_type = typename extractor_type::result_type;
+         using set_type = std::set<std::pair<secondary_key_type, uint64_t>>;
+         using set_iterator = typename set_type::const_iterator;
+
+         static constexpr uint64_t index_name = static_cast<uint64_t>(index_type::index_name);
+
+         class const_iterator {
+         public:
+            using iterator_category = std::bidirectional_iterator_tag;
+            using value_type = const T;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const T*;
+            using reference = const T&;
+
+            const_iterator() = default;
+
+            const T& operator*() const {
+               check(_it != _idx->set().end(), "cannot dereference end iterator");
+               auto row = _idx->_multidx->_data->rows.find(_it->second);
+               _idx->_multidx->load(row);
+               return row->second;
+            }
+            const T* operator->() const { return &operator*(); }
+
+            const_iterator operator++(int) { const_iterator result(*this); ++(*this); return result; }
+            const_iterator operator--(int) { const_iterator result(*this); --(*this); return result; }
+
+            const_iterator& operator++() {
+               check(_it != _idx->set().end(), "cannot increment end iterator");
+               native::counters().idx_next++;
+               ++_it;
+               return *this;
+            }
+
+            const_iterator& operator--() {
+               check(_it != _idx->set().begin(), "cannot decrement iterator at beginning of index");
+               native::counters().idx_previous++;
+               --_it;
+               return *this;
+            }
+
+            friend bool operator==(const const_iterator& a, const const_iterator& b) { return a._it == b._it; }
+            friend bool operator!=(const const_iterator& a, const const_iterator& b) { return a._it != b._it; }
+
+         private:
+            friend class index;
+            const_iterator(const index* idx, set_iterator it) : _idx(idx), _it(it) {}
+
+            const index* _idx = nullptr;
+            set_iterator _it;
+         };
+
+         typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+
+         const_iterator cbegin() const {
+            native::counters().idx_lowerbound++;
+            return const_iterator(this, set().begin());
+         }
+         const_iterator begin() const { return cbegin(); }
+         const_iterator cend() const { return const_iterator(this, set().end()); }
+         const_iterator end() const { return cend(); }
+
+         const_reverse_iterator rbegin() const { return std::make_reverse_iterator(cend()); }
+         const_reverse_iterator rend() const { return std::make_reverse_iterator(cbegin()); }
+
+         const_iterator lower_bound(const secondary_key_type& secondary) const {
+            native::counters().idx_lowerbound++;
+            countStorageSeek();
+            return const_iterator(this, set().lower_bound(std::make_pair(secondary, uint64_t(0))));
+         }
+
+         const_iterator upper_bound(const secondary_key_type& secondary) const {
+            native::counters().idx_upperbound++;
+            return const_iterator(this, set().upper_bound(std::make_pair(secondary, std::numeric_limits<uint64_t>::max())));
+         }
+
+         const_iterator find(const secondary_key_type& secondary) const {
+            native::counters().idx_find++;
+            countStorageSeek();
+            auto it = set().lower_bound(std::make_pair(secondary, uint64_t(0)));
+            if (it == set().end() || it->first != secondary) {
+               return cend();
+            }
+            return const_iterator(this, it);
+         }
+
+         const_iterator require_find(const secondary_key_type& secondary, const char* error_msg = "unable to find secondary key") const {
+            auto itr = find(secondary);
+            check(itr != cend(), error_msg);
+            return itr;
+         }
+
+         const T& get(const secondary_key_type& secondary, const char* error_msg = "unable to find secondary key") const {
+            return *require_find(secondary, error_msg);
+         }
+
+         const_iterator iterator_to(const T& obj) const {
+            return const_iterator(this, set().find(std::make_pair(extractor_type{}(obj), obj.primary_key())));
+         }
+
+         template <typename Lambda>
+         void modify(const_iterator itr, name payer, Lambda&& updater) {
+            check(itr != cend(), "cannot pass end iterator to modify");
+            _multidx->modify(*itr, payer, std::forward<Lambda&&>(updater));
+         }
+
+         const_iterator erase(const_iterator itr) {
+            check(itr != cend(), "cannot pass end iterator to erase");
+            const auto& obj = *itr;
+            ++itr;
+            _multidx->erase(obj);
+            return itr;
+         }
+
+         static auto extract_secondary_key(const T& obj) { return extractor_type{}(obj); }
+
+         name get_code() const { return _multidx->get_code(); }
+         uint64_t get_scope() const { return _multidx->get_scope(); }
+
+      private:
+         friend class multi_index;
+         index(multi_index* midx) : _multidx(midx) {}
+
+         const set_type& set() const { return std::get<I>(_multidx->_data->indices); }
+
+         void countStorageSeek() const {
+            if (TableName == "accountstate"_n && get_code() == "eosio.evm"_n) native::counters().storage_seeks++;
+         }
+
+         multi_index* _multidx;
+      };
+
+      multi_index(name code, uint64_t scope)
+         : _code(code), _scope(scope),
+           _data(&native::open_table<data_type>(code.value, scope, static_cast<uint64_t>(TableName))) {}
+
+      multi_index(const multi_index& other)
+         : _code(other._code), _scope(other._scope), _data(other._data) {}
+
+      // Points at the other table with a cache of its own, like the copy
+      multi_index& operator=(const multi_index& other) {
+         _code = other._code;
+         _scope = other._scope;
+         _data = other._data;
+         _next_primary_key = unset_next_primary_key;
+         _loaded.clear();
+         return *this;
+      }
+
+      name get_code() const { return _code; }
+      uint64_t get_scope() const { return _scope; }
+
+      const_iterator cbegin() const { return lower_bound(std::numeric_limits<uint64_t>::lowest()); }
+      const_iterator begin() const { return cbegin(); }
+      const_iterator cend() const { return const_iterator(this, _data->rows.end()); }
+      const_iterator end() const { return cend(); }
+
+      const_reverse_iterator crbegin() const { return std::make_reverse_iterator(cend()); }
+      const_reverse_iterator rbegin() const { return crbegin(); }
+      const_reverse_iterator crend() const { return std::make_reverse_iterator(cbegin()); }
+      const_reverse_iterator rend() const { return crend(); }
+
+      const_iterator lower_bound(uint64_t primary) const {
+         native::counters().db_lowerbound++;
+         auto it = _data->rows.lower_bound(primary);
+         load(it);
+         return const_iterator(this, it);
+      }
+
+      const_iterator upper_bound(uint64_t primary) const {
+         native::counters().db_upperbound++;
+         auto it = _data->rows.upper_bound(primary);
+         load(it);
+         return const_iterator(this, it);
+      }
+
+      uint64_t available_primary_key() const {
+         if (_next_primary_key == unset_next_primary_key) {
+            if (begin() == end()) {
+               _next_primary_key = 0;
+            } else {
+               auto itr = --end();
+               auto pk = itr->primary_key();
+               _next_primary_key = pk >= no_available_primary_key ? no_available_primary_key : pk + 1;
+            }
+         }
+         check(_next_primary_key < no_available_primary_key, "next primary key in table is at autoincrement limit");
+         return _next_primary_key;
+      }
+
+      template <name::raw IndexName>
+      auto get_index() {
+         constexpr size_t position = native::index_position<static_cast<uint64_t>(IndexName), Indices...>();
+         static_assert(position < sizeof...(Indices), "name provided is not the name of any secondary index within multi_index");
+         return index<position>(this);
+      }
+
+      template <name::raw IndexName>
+      auto get_index() const {
+         constexpr size_t position = native::index_position<static_cast<uint64_t>(IndexName), Indices...>();
+         static_assert(position < sizeof...(Indices), "name provided is not the name of any secondary index within multi_index");
+         return index<position>(const_cast<multi_index*>(this));
+      }
+
+      const_iterator iterator_to(const T& obj) const { return const_iterator(this, _data->rows.find(obj.primary_key())); }
+
+      template <typename Lambda>
+      const_iterator emplace(name payer, Lambda&& constructor) {
+         check(payer.value != 0, "cannot set payer to the empty name when emplacing");
+
+         T obj = T();
+         constructor(obj);
+
+         const auto pk = obj.primary_key();
+         check(_data->rows.find(pk) == _data->rows.end(), "could not insert object, most likely a uniqueness constraint was violated");
+
+         auto it = _data->rows.emplace(pk, std::move(obj)).first;
+         _data->insert_secondaries(it->second, pk);
+         _loaded.insert(pk);
+
+         auto& c = native::counters();
+         c.db_store += 1 + sizeof...(Indices);
+         c.bytes_written += native::row_size(it->second);
+
+         if (pk >= _next_primary_key) {
+            _next_primary_key = (pk >= no_available_primary_key) ? no_available_primary_key : (pk + 1);
+         }
+         return const_iterator(this, it);
+      }
+
+      template <typename Lambda>
+      void modify(const_iterator itr, name payer, Lambda&& updater) {
+         check(itr != end(), "cannot pass end iterator to modify");
+         modify(*itr, payer, std::forward<Lambda&&>(updater));
+      }
+
+      template <typename Lambda>
+      void modify(const T& obj, name payer, Lambda&& updater) {
+         const auto pk = obj.primary_key();
+         auto it = _data->rows.find(pk);
+         check(it != _data->rows.end(), "object passed to modify is not in multi_index");
+
+         T& mutable_obj = it->second;
+         _data->erase_secondaries(mutable_obj, pk);
+         updater(mutable_obj);
+         check(pk == mutable_obj.primary_key(), "updater cannot change primary key when modifying an object");
+         _data->insert_secondaries(mutable_obj, pk);
+
+         auto& c = native::counters();
+         c.db_update++;
+         c.bytes_written += native::row_size(mutable_obj);
+      }
+
+      const T& get(uint64_t primary, const char* error_msg = "unable to find key") const {
+         auto result = find(primary);
+         check(result != cend(), error_msg);
+         return *result;
+      }
+
+      const_iterator find(uint64_t primary) const {
+         native::counters().db_find++;
+         auto it = _data->rows.find(primary);
+         load(it);
+         return const_iterator(this, it);
+      }
+
+      const_iterator require_find(uint64_t primary, const char* error_msg = "unable to find key") const {
+         auto itr = find(primary);
+         check(itr != cend(), error_msg);
+         return itr;
+      }
+
+      const_iterator erase(const_iterator itr) {
+         check(itr != end(), "cannot pass end iterator to erase");
+         const auto& obj = *itr;
+         ++itr;
+         erase(obj);
+         return itr;
+      }
+
+      void erase(const T& obj) {
+         const auto pk = obj.primary_key();
+         auto it = _data->rows.find(pk);
+         check(it != _data->rows.end(), "object passed to erase is not in multi_index");
+
+         _data->erase_secondaries(it->second, pk);
+         _data->rows.erase(it);
+         _loaded.erase(pk);
+
+         native::counters().db_remove += 1 + sizeof...(Indices);
+      }
+   };
+}
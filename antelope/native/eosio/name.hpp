@@ -0,0 +1,114 @@
+// Native stand-in for <eosio/name.hpp>
+#pragma once
+
+#include <eosio/check.hpp>
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace eosio {
+   /**
+    * Antelope account name, base32 encoded into a uint64_t
+    */
+   struct name {
+   public:
+      enum class raw : uint64_t {};
+
+      constexpr name() : value(0) {}
+      constexpr explicit name(uint64_t v) : value(v) {}
+      constexpr explicit name(name::raw r) : value(static_cast<uint64_t>(r)) {}
+
+      constexpr explicit name(std::string_view str) : value(0) {
+         if (str.size() > 13) {
+            check(false, "string is too long to be a valid name");
+         }
+         if (str.empty()) {
+            return;
+         }
+
+         auto n = str.size() < 12 ? str.size() : 12;
+         for (decltype(n) i = 0; i < n; ++i) {
+            value <<= 5;
+            value |= char_to_value(str[i]);
+         }
+         value <<= (4 + 5 * (12 - n));
+         if (str.size() == 13) {
+            uint64_t v = char_to_value(str[12]);
+            if (v > 0x0Full) {
+               check(false, "thirteenth character in name cannot be a letter that comes after j");
+            }
+            value |= v;
+         }
+      }
+
+      static constexpr uint8_t char_to_value(char c) {
+         if (c == '.')
+            return 0;
+         else if (c >= '1' && c <= '5')
+            return (c - '1') + 1;
+         else if (c >= 'a' && c <= 'z')
+            return (c - 'a') + 6;
+         else
+            check(false, "character is not in allowed character set for names");
+
+         return 0;
+      }
+
+      constexpr uint8_t length() const {
+         constexpr uint64_t mask = 0xF800000000000000ull;
+
+         if (value == 0)
+            return 0;
+
+         uint8_t l = 0;
+         uint8_t i = 0;
+         for (auto v = value; i < 13; ++i, v <<= 5) {
+            if ((v & mask) > 0) {
+               l = i;
+            }
+         }
+
+         return l + 1;
+      }
+
+      constexpr operator raw() const { return raw(value); }
+      constexpr explicit operator bool() const { return value != 0; }
+
+      char* write_as_string(char* begin, char* end) const {
+         static const char* charmap = ".12345abcdefghijklmnopqrstuvwxyz";
+         constexpr uint64_t mask = 0xF800000000000000ull;
+
+         if ((begin + 13) < begin || (begin + 13) > end) return begin;
+
+         auto v = value;
+         for (auto i = 0; i < 13; ++i, v <<= 5) {
+            if (v == 0) return begin;
+
+            auto indx = (v & mask) >> (i == 12 ? 60 : 59);
+            *begin = charmap[indx];
+            ++begin;
+         }
+
+         return begin;
+      }
+
+      std::string to_string() const {
+         char buffer[13];
+         auto end = write_as_string(buffer, buffer + sizeof(buffer));
+         return {buffer, end};
+      }
+
+      friend constexpr bool operator==(const name& a, const name& b) { return a.value == b.value; }
+      friend constexpr bool operator!=(const name& a, const name& b) { return a.value != b.value; }
+      friend constexpr bool operator<(const name& a, const name& b) { return a.value < b.value; }
+
+      uint64_t value = 0;
+   };
+
+   inline namespace literals {
+      constexpr name operator""_n(const char* s, std::size_t n) { return name(std::string_view(s, n)); }
+   }
+}
+
+using namespace eosio::literals;
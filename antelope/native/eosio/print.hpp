@@ -0,0 +1,12 @@
+// Native stand-in for <eosio/print.hpp>
+#pragma once
+
+#include <iostream>
+
+namespace eosio {
+   // The action console, kept off stdout so it never mixes with the reports of the native tools
+   template <typename... Args>
+   void print(Args&&... args) {
+      (std::cerr << ... << args);
+   }
+}
@@ -0,0 +1,22 @@
+// Native stand-in for <eosio/system.hpp>
+#pragma once
+
+#include <eosio/check.hpp>
+#include <eosio/host.hpp>
+#include <eosio/name.hpp>
+#include <eosio/time.hpp>
+
+namespace eosio {
+   inline time_point current_time_point() { return native::host().now; }
+
+   inline time_point_sec current_block_time() { return time_point_sec(native::host().now); }
+
+   inline bool has_auth(name n) {
+      const auto& auths = native::host().auths;
+      return auths.empty() || auths.count(n.value) > 0;
+   }
+
+   inline void require_auth(name n) { check(has_auth(n), "missing authority of " + n.to_string()); }
+
+   inline bool is_account(name n) { return native::host().missing_accounts.count(n.value) == 0; }
+}
@@ -0,0 +1,54 @@
+// Native stand-in for <eosio/time.hpp>
+#pragma once
+
+#include <cstdint>
+
+namespace eosio {
+   class microseconds {
+   public:
+      explicit microseconds(int64_t c = 0) : _count(c) {}
+
+      int64_t count() const { return _count; }
+      int64_t to_seconds() const { return _count / 1000000; }
+
+      microseconds operator+(const microseconds& m) const { return microseconds(_count + m._count); }
+      microseconds operator-(const microseconds& m) const { return microseconds(_count - m._count); }
+      bool operator==(const microseconds& c) const { return _count == c._count; }
+      bool operator<(const microseconds& c) const { return _count < c._count; }
+
+      int64_t _count;
+   };
+
+   inline microseconds seconds(int64_t s) { return microseconds(s * 1000000); }
+   inline microseconds milliseconds(int64_t s) { return microseconds(s * 1000); }
+
+   class time_point {
+   public:
+      explicit time_point(microseconds e = microseconds()) : elapsed(e) {}
+
+      const microseconds& time_since_epoch() const { return elapsed; }
+      uint32_t sec_since_epoch() const { return uint32_t(elapsed.count() / 1000000); }
+
+      time_point operator+(const microseconds& m) const { return time_point(elapsed + m); }
+      time_point operator-(const microseconds& m) const { return time_point(elapsed - m); }
+      bool operator==(const time_point& t) const { return elapsed == t.elapsed; }
+      bool operator<(const time_point& t) const { return elapsed < t.elapsed; }
+
+      microseconds elapsed;
+   };
+
+   class time_point_sec {
+   public:
+      time_point_sec() : utc_seconds(0) {}
+      explicit time_point_sec(uint32_t seconds) : utc_seconds(seconds) {}
+      time_point_sec(const time_point& t) : utc_seconds(uint32_t(t.time_since_epoch().count() / 1000000ll)) {}
+
+      uint32_t sec_since_epoch() const { return utc_seconds; }
+      operator time_point() const { return time_point(eosio::seconds(utc_seconds)); }
+
+      bool operator==(const time_point_sec& t) const { return utc_seconds == t.utc_seconds; }
+      bool operator<(const time_point_sec& t) const { return utc_seconds < t.utc_seconds; }
+
+      uint32_t utc_seconds;
+   };
+}
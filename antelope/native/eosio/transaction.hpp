@@ -0,0 +1,5 @@
+// Native stand-in for <eosio/transaction.hpp>
+#pragma once
+
+#include <eosio/action.hpp>
+#include <eosio/time.hpp>
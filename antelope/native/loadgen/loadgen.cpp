@@ -0,0 +1,405 @@
+// Load generator: fills TokenBridge & PairBridgeRegister storage in the emulator, then cranks the contract's actions
+// and reports the host calls each crank makes, per queue depth & pair count
+// Build with CMake from antelope/, then run ./loadgen [--depths 1000,5000] [--pairs 1,10,100] [--max-items <n>] [--max-cost <n>] [--csv]
+
+#include "../../src/token.brdg.cpp"
+
+#include "../emulator/bridge_fixture.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+
+using namespace evm_bridge;
+
+namespace
+{
+  using emulator::bridge_fixture;
+
+  constexpr eosio::name SELF = bridge_fixture::SELF;
+  constexpr eosio::name TOKEN = bridge_fixture::TOKEN;
+  constexpr uint64_t MAX_CRANKS = 1000000;
+  constexpr uint64_t DEPOSITS_PER_TRANSACTION = 2;
+  constexpr uint64_t SHARDS = 4;
+  constexpr uint64_t UPGRADE_FIRST_ID = 1000000;
+  constexpr uint64_t UPGRADE_LEGACY_ITEMS = 2;
+
+  struct options {
+    std::vector<uint64_t> depths = { 1000, 5000, 10000 };
+    std::vector<uint64_t> pairs = { 1, 10, 100 };
+    uint64_t max_items = DEFAULT_NOTIFY_MAX_ITEMS;
+    uint64_t max_cost = DEFAULT_NOTIFY_BUDGET;
+    bool csv = false;
+  };
+
+  struct crank_stats {
+    uint64_t cranks = 0;
+    emulator::measurement first;
+    eosio::native::host_counters total;
+    uint64_t total_ns = 0;
+    uint64_t max_reads = 0;
+
+    void add(const emulator::measurement& m)
+    {
+      if (cranks++ == 0) first = m;
+      const auto& c = m.counters;
+      total.db_find += c.db_find; total.db_lowerbound += c.db_lowerbound; total.db_upperbound += c.db_upperbound;
+      total.db_next += c.db_next; total.db_previous += c.db_previous; total.db_get += c.db_get;
+      total.db_store += c.db_store; total.db_update += c.db_update; total.db_remove += c.db_remove;
+      total.idx_find += c.idx_find; total.idx_lowerbound += c.idx_lowerbound; total.idx_upperbound += c.idx_upperbound;
+      total.idx_next += c.idx_next; total.idx_previous += c.idx_previous; total.storage_seeks += c.storage_seeks;
+      total.bytes_read += c.bytes_read; total.bytes_written += c.bytes_written;
+      total.inline_actions += c.inline_actions; total.inline_bytes += c.inline_bytes;
+      total_ns += m.ns;
+      max_reads = std::max(max_reads, c.db_reads());
+    }
+  };
+
+  // Cranks a notify action until it reports nothing pending, settling the EVM callbacks in between
+  crank_stats drain(bridge_fixture& bridge, notify_result (tokenbridge::*notify)(uint64_t, uint64_t))
+  {
+    crank_stats stats;
+    notify_result result { 0, 1 };
+    while (result.pending > 0 && stats.cranks < MAX_CRANKS) {
+      auto c = bridge_fixture::contract();
+      const auto m = emulator::measure([&] { result = (c.*notify)(0, 1); });
+      stats.add(m);
+      bridge.settle(m.actions);
+      eosio::native::host().now = eosio::native::host().now + eosio::milliseconds(500);
+    }
+    eosio::check(result.pending == 0, "Queue did not drain");
+    return stats;
+  }
+
+  // Cranks process for each shard in turn, as relayers splitting the queues would, until both EVM arrays are empty
+  crank_stats drainSharded(bridge_fixture& bridge, uint64_t shard_count)
+  {
+    crank_stats stats;
+    while ((bridge.requests.length() > 0 || bridge.refunds.length() > 0) && stats.cranks < MAX_CRANKS) {
+      const uint64_t shard_id = stats.cranks % shard_count;
+      auto c = bridge_fixture::contract();
+      const auto m = emulator::measure([&] { c.process(shard_id, shard_count); });
+      stats.add(m);
+      bridge.settle(m.actions);
+      eosio::native::host().now = eosio::native::host().now + eosio::milliseconds(500);
+    }
+    eosio::check(bridge.requests.length() == 0 && bridge.refunds.length() == 0, "Shards did not drain the queues");
+    return stats;
+  }
+
+  // Cranks process with the shard count changing between cranks, each crank's EVM callbacks only settling after the next
+  // crank ran: items paid out but still on EVM are seen by cranks of other shard counts, none may pay them again
+  crank_stats drainResharded(bridge_fixture& bridge)
+  {
+    constexpr uint64_t SHARD_COUNTS[] = { 2, 1, 4, 8 };
+    crank_stats stats;
+    std::vector<eosio::native::sent_action> unsettled;
+    while ((bridge.requests.length() > 0 || bridge.refunds.length() > 0) && stats.cranks < MAX_CRANKS) {
+      const uint64_t shard_count = SHARD_COUNTS[stats.cranks % std::size(SHARD_COUNTS)];
+      const uint64_t shard_id = (stats.cranks / std::size(SHARD_COUNTS)) % shard_count;
+      auto c = bridge_fixture::contract();
+      const auto m = emulator::measure([&] { c.process(shard_id, shard_count); });
+      stats.add(m);
+      bridge.settle(unsettled);
+      unsettled = m.actions;
+      eosio::native::host().now = eosio::native::host().now + eosio::milliseconds(500);
+    }
+    bridge.settle(unsettled);
+    eosio::check(bridge.requests.length() == 0 && bridge.refunds.length() == 0, "Resharded cranks did not drain the queues");
+    return stats;
+  }
+
+  // An upgrade from the contract without dedupe rows: the ids on EVM are far above the dedupe watermarks, and the first
+  // `legacy` of them were paid out before the upgrade with their callbacks still in flight, in the legacy tables
+  crank_stats drainUpgrade(const options& opts, uint64_t depth, uint64_t pair_count, uint64_t legacy)
+  {
+    bridge_fixture bridge(pair_count, opts.max_items, opts.max_cost);
+    bridge.next_id = UPGRADE_FIRST_ID;
+    bridge.queue(depth);
+    requests_table legacy_requests(SELF, SELF.value);
+    refunds_table legacy_refunds(SELF, SELF.value);
+    for (uint64_t id = UPGRADE_FIRST_ID; id < UPGRADE_FIRST_ID + legacy; id++) {
+      legacy_requests.emplace(SELF, [&](auto& r) {
+        r.request_id = legacy_requests.available_primary_key();
+        r.call_id = toChecksum256(uint256_t(id));
+        r.timestamp = eosio::native::host().now;
+      });
+      legacy_refunds.emplace(SELF, [&](auto& r) {
+        r.refund_id = legacy_refunds.available_primary_key();
+        r.call_id = toChecksum256(uint256_t(id));
+        r.timestamp = eosio::native::host().now;
+      });
+    }
+
+    const crank_stats stats = drain(bridge, &tokenbridge::process);
+    eosio::check(bridge.requests.length() == legacy && bridge.refunds.length() == legacy, "Upgraded queues did not drain past the legacy items");
+    const auto totals = bridge_fixture::statsTotals();
+    eosio::check(totals.requests_processed == depth - legacy && totals.refunds_processed == depth - legacy, "Legacy items were paid out again");
+    return stats;
+  }
+
+  crank_stats syncAll(uint64_t pair_count, uint64_t max)
+  {
+    crank_stats stats;
+    for (uint64_t synced = 0; synced < pair_count; synced += max) {
+      auto c = bridge_fixture::contract();
+      stats.add(emulator::measure([&] { c.syncpairs(max); }));
+    }
+    return stats;
+  }
+
+  // Removes the first pair from the register: syncing every pair must erase its cache row & move the last one in its place
+  crank_stats syncRemoved(bridge_fixture& bridge, uint64_t max)
+  {
+    pairs_table cache(SELF, TOKEN.value);
+    const uint64_t last = bridge.pairs.length() - 1;
+    eosio::symbol_code removed, moved;
+    for (const auto& p : cache) {
+      if (p.evm_index == 0) removed = p.antelope_symbol;
+      if (p.evm_index == last) moved = p.antelope_symbol;
+    }
+    bridge.removePair(0);
+
+    // Two rounds, the check of the cached pairs may resume midway through them
+    const crank_stats stats = syncAll(2 * (last + 1), max);
+    eosio::check(cache.find(removed.raw()) == cache.end(), "The removed pair is still cached");
+    eosio::check(last == 0 || cache.require_find(moved.raw(), "The moved pair is not cached")->evm_index == 0, "The moved pair was not synced");
+    return stats;
+  }
+
+  // Runs the read only queries over the last page, the reqnotify dry run must match the pending requests it would pay out,
+  // from the last one down
+  crank_stats queryPending()
+  {
+    crank_stats stats;
+    auto c = bridge_fixture::contract();
+    pending_requests pending;
+    notify_preview preview;
+    const uint64_t total = c.pending(0, 1).total;
+    const uint64_t offset = total > MAX_QUERY_ITEMS ? total - MAX_QUERY_ITEMS : 0;
+    stats.add(emulator::measure([&] { pending = c.pending(offset, MAX_QUERY_ITEMS); }));
+    stats.add(emulator::measure([&] { c.pendrefunds(0, MAX_QUERY_ITEMS); }));
+    stats.add(emulator::measure([&] { c.evmpairs(0, MAX_QUERY_ITEMS); }));
+    stats.add(emulator::measure([&] { preview = c.reqpreview(); }));
+
+    eosio::check(preview.items.size() == preview.result.processed && preview.items.size() <= pending.items.size(), "Preview does not match the pending requests");
+    for (size_t i = 0; i < preview.items.size(); i++) {
+      const auto& expected = pending.items[pending.items.size() - 1 - i];
+      eosio::check(preview.items[i].call_id == expected.call_id && preview.items[i].quantity == expected.quantity, "Preview does not match the pending requests");
+    }
+    return stats;
+  }
+
+  // Bridges deposits notified one after the other in a single transaction: their bridgeTo calls only run on EVM once
+  // every notification has, so each one must take the nonce after the previous one's. Each writes the nonce & one metrics row
+  crank_stats bridgeDeposits(bridge_fixture& bridge)
+  {
+    crank_stats stats;
+    auto c = bridge_fixture::contract(TOKEN);
+    const std::string memo = "0x" + std::string(40, 'a');
+    std::vector<eosio::native::sent_action> actions;
+    for (uint64_t n = 0; n < DEPOSITS_PER_TRANSACTION; n++) {
+      const auto m = emulator::measure([&] { c.bridge("sender"_n, SELF, eosio::asset(10000, eosio::symbol(bridge_fixture::pairSymbol(0), bridge_fixture::ANTELOPE_PRECISION)), memo); });
+      eosio::check(m.counters.db_writes() <= 2, "A bridged transfer writes more than its nonce & metrics rows");
+      stats.add(m);
+      actions.insert(actions.end(), m.actions.begin(), m.actions.end());
+    }
+    bridge.settle(actions);
+    return stats;
+  }
+
+  // Bridges a batch of deposits with batching on, the one filling the batch sends them all in a single bridgeToBatch call
+  // The first pair leaves the register before the batch fills when the last deposit is of another pair: its deposits
+  // go back to their sender on Antelope instead of riding the batch
+  crank_stats bridgeBatched(bridge_fixture& bridge, uint64_t count, uint64_t pair_count)
+  {
+    crank_stats stats;
+    bridge_fixture::contract().setbatch(count);
+    auto c = bridge_fixture::contract(TOKEN);
+    const std::string memo = "0x" + std::string(40, 'a');
+    const bool remove_pair = (count - 1) % pair_count != 0;
+    uint64_t returned = 0;
+    for (uint64_t n = 0; n < count; n++) {
+      if (remove_pair && n == count - 1) bridge.removePair(0);
+      else if (remove_pair && n % pair_count == 0) returned++;
+      const auto m = emulator::measure([&] { c.bridge("sender"_n, SELF, eosio::asset(10000, eosio::symbol(bridge_fixture::pairSymbol(n % pair_count), bridge_fixture::ANTELOPE_PRECISION)), memo); });
+      stats.add(m);
+      bridge.settle(m.actions);
+    }
+    bridge_fixture::contract().setbatch(0);
+
+    deposits_table deposits(SELF, SELF.value);
+    eosio::check(deposits.begin() == deposits.end() && stats.total.inline_actions == 1 + returned, "Deposits were not sent in a single batch");
+    eosio::check(bridge_fixture::statsTotals().deposits_returned == returned, "Deposits of the removed pair were not returned");
+    return stats;
+  }
+
+  // EVM Storage seeks of a notify call over a queue inside the dedupe window: the array length & id counter, then one
+  // per item as the scan goes down the array, the members of an item being read in slot order
+  void checkStorageSeeks(const options& opts)
+  {
+    bridge_fixture bridge(1, opts.max_items, opts.max_cost);
+    bridge.queue(opts.max_items);
+    notify_preview preview;
+    const auto requests = emulator::measure([&] { preview = bridge_fixture::contract().reqpreview(); });
+    const auto refunds = emulator::measure([&] { bridge_fixture::contract().refundnotify(0, 1); });
+    const uint64_t items = preview.items.size();
+    std::fprintf(stderr, "storage seeks for %llu items: requests %llu, refunds %llu\n", (unsigned long long)items,
+      (unsigned long long)requests.counters.storage_seeks, (unsigned long long)refunds.counters.storage_seeks);
+    eosio::check(items > 0 && requests.counters.storage_seeks == 2 + items && refunds.counters.storage_seeks == 2 + items,
+      "Notify calls seek EVM Storage more than once per item");
+  }
+
+  // A pair registered with a name past MAX_STORAGE_STRING_LENGTH syncs & lists with its name truncated
+  void checkLongStrings(const options& opts)
+  {
+    bridge_fixture bridge(1, opts.max_items, opts.max_cost);
+    bridge.pairs.setString(0, pair_layout::evm_name, std::string(4 * MAX_STORAGE_STRING_LENGTH, 'n'));
+    bridge_fixture::contract().syncpairs(1);
+    const evm_pairs listed = bridge_fixture::contract().evmpairs(0, 1);
+    pairs_table cache(SELF, TOKEN.value);
+    const auto cached = cache.require_find(bridge_fixture::pairSymbol(0).raw(), "The long named pair is not cached");
+    eosio::check(cached->evm_name == std::string(MAX_STORAGE_STRING_LENGTH, 'n') && listed.items.at(0).evm_name == cached->evm_name,
+      "Long pair names are not truncated");
+  }
+
+  // A refund TokenBridge pushed without an Antelope token, as batches did for the items of a removed pair before they
+  // carried the token of each deposit, is settled on EVM without a transfer instead of holding up the queue forever
+  void checkUnresolvedRefund(const options& opts)
+  {
+    bridge_fixture bridge(1, opts.max_items, opts.max_cost);
+    bridge.queue(2);
+    bridge.refunds.setString(0, refund_layout::antelope_token, "");
+    bridge.refunds.setString(0, refund_layout::antelope_symbol, "");
+    const pending_refunds pending = bridge_fixture::contract().pendrefunds(0, 2);
+    eosio::check(pending.items.size() == 2 && !pending.items[0].resolved && pending.items[1].resolved, "Unresolved refund not listed as such");
+
+    const auto m = emulator::measure([&] { bridge_fixture::contract().refundnotify(0, 1); });
+    bridge.settle(m.actions);
+    const auto totals = bridge_fixture::statsTotals();
+    eosio::check(bridge.refunds.length() == 0 && m.counters.inline_actions == 2, "Unresolved refund was not settled on EVM without a transfer");
+    eosio::check(totals.refunds_processed == 2 && totals.refunds_unresolved == 1, "Unresolved refund not counted");
+  }
+
+  // Moving to a new TokenBridge, whose ids start over at 0, resets the dedupe rows & scan cursors: none of its items is skipped
+  void checkBridgeMove(const options& opts)
+  {
+    bridge_fixture bridge(1, opts.max_items, opts.max_cost);
+    bridge.queue(opts.max_items);
+    drain(bridge, &tokenbridge::reqnotify);
+    drain(bridge, &tokenbridge::refundnotify);
+    bridge.redeployBridge();
+    bridge.queue(opts.max_items);
+    drain(bridge, &tokenbridge::reqnotify);
+    drain(bridge, &tokenbridge::refundnotify);
+    const auto totals = bridge_fixture::statsTotals();
+    eosio::check(totals.requests_processed == 2 * opts.max_items && totals.refunds_processed == 2 * opts.max_items,
+      "Items of the new TokenBridge were skipped");
+  }
+
+  // The stats tables must account for every drained request & refund
+  void checkStats(uint64_t depth)
+  {
+    const auto totals = bridge_fixture::statsTotals();
+    eosio::check(totals.requests_processed == depth && totals.refunds_processed == depth, "Stats totals do not match the drained queues");
+
+    const auto tokens = bridge_fixture::tokenTotals(TOKEN);
+    eosio::check(tokens.requests_processed == depth && tokens.refunds_processed == depth && tokens.bridged == DEPOSITS_PER_TRANSACTION, "Token stats do not match the drained queues");
+  }
+
+  void printHeader(const options& opts)
+  {
+    if (opts.csv) {
+      std::printf("action,depth,pairs,cranks,first_db_reads,mean_db_reads,max_db_reads,mean_idx_searches,mean_storage_seeks,mean_db_gets,mean_db_writes,mean_bytes_read,mean_bytes_written,mean_inline_actions,mean_inline_bytes,mean_ns\n");
+    } else {
+      std::printf("%-14s %7s %6s %7s %10s %10s %10s %10s %10s %10s %10s %10s %10s %8s %10s %10s\n", "action", "depth", "pairs", "cranks",
+        "1st reads", "reads", "max reads", "searches", "seeks", "gets", "writes", "bytes rd", "bytes wr", "inlines", "inline B", "ns");
+    }
+  }
+
+  void printStats(const options& opts, const char* action, uint64_t depth, uint64_t pairs, const crank_stats& s)
+  {
+    const double n = double(std::max<uint64_t>(s.cranks, 1));
+    const auto& t = s.total;
+    const char* format = opts.csv
+      ? "%s,%llu,%llu,%llu,%llu,%.1f,%llu,%.1f,%.1f,%.1f,%.1f,%.1f,%.1f,%.1f,%.1f,%.0f\n"
+      : "%-14s %7llu %6llu %7llu %10llu %10.1f %10llu %10.1f %10.1f %10.1f %10.1f %10.1f %10.1f %8.1f %10.1f %10.0f\n";
+    std::printf(format, action, (unsigned long long)depth, (unsigned long long)pairs, (unsigned long long)s.cranks,
+      (unsigned long long)s.first.counters.db_reads(), t.db_reads() / n, (unsigned long long)s.max_reads, t.idx_searches() / n, t.storage_seeks / n, t.db_get / n, t.db_writes() / n,
+      t.bytes_read / n, t.bytes_written / n, t.inline_actions / n, t.inline_bytes / n, s.total_ns / n);
+    std::fflush(stdout);
+  }
+
+  std::vector<uint64_t> parseList(const std::string& value)
+  {
+    std::vector<uint64_t> list;
+    std::stringstream ss(value);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+      const uint64_t parsed = std::strtoull(item.c_str(), nullptr, 10);
+      if (parsed > 0) list.push_back(parsed);
+    }
+    return list;
+  }
+}
+
+int main(int argc, char** argv)
+{
+  options opts;
+  for (int i = 1; i < argc; i++) {
+    const std::string arg = argv[i];
+    if (arg == "--depths" && i + 1 < argc) opts.depths = parseList(argv[++i]);
+    else if (arg == "--pairs" && i + 1 < argc) opts.pairs = parseList(argv[++i]);
+    else if (arg == "--max-items" && i + 1 < argc) opts.max_items = std::strtoull(argv[++i], nullptr, 10);
+    else if (arg == "--max-cost" && i + 1 < argc) opts.max_cost = std::strtoull(argv[++i], nullptr, 10);
+    else if (arg == "--csv") opts.csv = true;
+    else {
+      std::fprintf(stderr, "usage: %s [--depths <n,...>] [--pairs <n,...>] [--max-items <n>] [--max-cost <n>] [--csv]\n", argv[0]);
+      return 1;
+    }
+  }
+
+  try {
+    checkStorageSeeks(opts);
+    checkLongStrings(opts);
+    checkBridgeMove(opts);
+    checkUnresolvedRefund(opts);
+    printHeader(opts);
+    for (const uint64_t pair_count : opts.pairs) {
+      for (const uint64_t depth : opts.depths) {
+        bridge_fixture bridge(pair_count, opts.max_items, opts.max_cost);
+        bridge.queue(depth);
+        printStats(opts, "syncpairs", depth, pair_count, syncAll(pair_count, opts.max_items));
+        printStats(opts, "bridge", depth, pair_count, bridgeDeposits(bridge));
+        printStats(opts, "queries", depth, pair_count, queryPending());
+        printStats(opts, "reqnotify", depth, pair_count, drain(bridge, &tokenbridge::reqnotify));
+        printStats(opts, "refundnotify", depth, pair_count, drain(bridge, &tokenbridge::refundnotify));
+        checkStats(depth);
+
+        // Same backlog again, both queues drained by the combined action
+        bridge.queue(depth);
+        printStats(opts, "process", depth, pair_count, drain(bridge, &tokenbridge::process));
+        checkStats(2 * depth);
+
+        // And again, split between shards whose cranks take turns
+        bridge.queue(depth);
+        printStats(opts, "process x4", depth, pair_count, drainSharded(bridge, SHARDS));
+        checkStats(3 * depth);
+
+        // And again, changing the shard count as the cranks go
+        bridge.queue(depth);
+        printStats(opts, "reshard", depth, pair_count, drainResharded(bridge));
+        checkStats(4 * depth);
+        printStats(opts, "bridge batch", depth, pair_count, bridgeBatched(bridge, 10, pair_count));
+        printStats(opts, "sync removed", depth, pair_count, syncRemoved(bridge, opts.max_items));
+
+        // A fresh contract upgraded under a backlog
+        printStats(opts, "upgrade", depth, pair_count, drainUpgrade(opts, depth, pair_count, std::min(depth, UPGRADE_LEGACY_ITEMS)));
+      }
+    }
+  } catch (const eosio::eosio_assert_exception& e) {
+    std::fprintf(stderr, "assertion failure: %s\n", e.what());
+    return 1;
+  }
+  return 0;
+}
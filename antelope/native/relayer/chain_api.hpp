@@ -0,0 +1,41 @@
+// What the relayer needs from a chain: token.brdg's config, eosio.evm storage words & notify pushes
+#pragma once
+
+#include <token.brdg.hpp>
+
+#include <string>
+
+namespace relayer
+{
+  using namespace evm_bridge;
+
+  // The parts of token.brdg's bridgeconfig & settings the relayer polls with
+  struct bridge_info {
+    uint64_t evm_bridge_scope = 0;
+    uint64_t notify_max_items = DEFAULT_NOTIFY_MAX_ITEMS;
+  };
+
+  struct push_result {
+    bool ok = false;
+    std::string transaction_id;
+    notify_result result { 0, 0 };
+    std::string error;
+  };
+
+  /**
+   * Chain access, implemented over nodeos' HTTP API (http_chain_api.hpp) or anything else that can read & push
+   * Pushes may be called from several threads at once, reads from the polling thread only
+   */
+  class chain_api {
+    public:
+      virtual ~chain_api() = default;
+
+      virtual bridge_info bridge(eosio::name contract) = 0;
+
+      // One eosio.evm accountstate word, zero when there is no row
+      virtual uint256_t readStorage(uint64_t scope, const eosio::checksum256& key) = 0;
+
+      // Pushes contract::action(data) in its own transaction & decodes the notify_result it returned
+      virtual push_result push(eosio::name contract, eosio::name action, const std::vector<char>& data) = 0;
+  };
+} // namespace relayer
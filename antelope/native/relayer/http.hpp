@@ -0,0 +1,195 @@
+// Minimal HTTP/1.1 over POSIX sockets: a POST client for the chain & wallet APIs and a single threaded server for mocks
+// Plain http:// only, point the relayer at a local node or a TLS terminating proxy
+#pragma once
+
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cstring>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+namespace http
+{
+  struct error : std::runtime_error {
+    using std::runtime_error::runtime_error;
+  };
+
+  struct response {
+    int status = 0;
+    std::string body;
+  };
+
+  struct endpoint {
+    std::string host;
+    std::string port;
+
+    // http://host[:port][/], anything else is rejected
+    static endpoint parse(const std::string& url)
+    {
+      const std::string scheme = "http://";
+      if (url.compare(0, scheme.size(), scheme) != 0) throw error("Only http:// URLs are supported: " + url);
+      std::string authority = url.substr(scheme.size());
+      authority = authority.substr(0, authority.find('/'));
+      const size_t colon = authority.rfind(':');
+      if (colon == std::string::npos) return endpoint { authority, "80" };
+      return endpoint { authority.substr(0, colon), authority.substr(colon + 1) };
+    }
+  };
+
+  namespace detail
+  {
+    inline void sendAll(int fd, const std::string& data)
+    {
+      for (size_t sent = 0; sent < data.size();) {
+        const ssize_t n = ::send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+        if (n <= 0) throw error("send failed");
+        sent += size_t(n);
+      }
+    }
+
+    // Reads the head & a Content-Length body, or everything up to EOF when there is no length
+    inline bool readMessage(int fd, std::string& head, std::string& body)
+    {
+      std::string data;
+      char buffer[4096];
+      size_t header_end = std::string::npos;
+      size_t content_length = std::string::npos;
+      while (true) {
+        if (header_end != std::string::npos && content_length != std::string::npos && data.size() >= header_end + 4 + content_length) break;
+        const ssize_t n = ::recv(fd, buffer, sizeof(buffer), 0);
+        if (n < 0) return false;
+        if (n == 0) break;
+        data.append(buffer, size_t(n));
+        if (header_end == std::string::npos && (header_end = data.find("\r\n\r\n")) != std::string::npos) {
+          std::string lower = data.substr(0, header_end);
+          for (auto& c : lower) c = char(tolower(c));
+          const size_t field = lower.find("\r\ncontent-length:");
+          if (field != std::string::npos) content_length = std::stoul(lower.substr(field + 17));
+        }
+      }
+      if (header_end == std::string::npos) return false;
+      head = data.substr(0, header_end);
+      body = data.substr(header_end + 4, content_length);
+      return true;
+    }
+  } // namespace detail
+
+  /**
+   * POSTs a JSON body, one connection per request so concurrent callers never share a socket
+   */
+  inline response post(const endpoint& to, const std::string& path, const std::string& body)
+  {
+    addrinfo hints = {};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* addresses = nullptr;
+    if (getaddrinfo(to.host.c_str(), to.port.c_str(), &hints, &addresses) != 0) throw error("Cannot resolve " + to.host);
+
+    int fd = -1;
+    for (addrinfo* a = addresses; a && fd < 0; a = a->ai_next) {
+      fd = ::socket(a->ai_family, a->ai_socktype, a->ai_protocol);
+      if (fd >= 0 && ::connect(fd, a->ai_addr, a->ai_addrlen) != 0) {
+        ::close(fd);
+        fd = -1;
+      }
+    }
+    freeaddrinfo(addresses);
+    if (fd < 0) throw error("Cannot connect to " + to.host + ":" + to.port);
+
+    response r;
+    try {
+      detail::sendAll(fd, "POST " + path + " HTTP/1.1\r\nHost: " + to.host + "\r\nContent-Type: application/json\r\n"
+        "Content-Length: " + std::to_string(body.size()) + "\r\nConnection: close\r\n\r\n" + body);
+      std::string head;
+      if (!detail::readMessage(fd, head, r.body)) throw error("Malformed HTTP response from " + to.host);
+      const size_t space = head.find(' ');
+      r.status = space == std::string::npos ? 0 : std::atoi(head.c_str() + space + 1);
+    } catch (...) {
+      ::close(fd);
+      throw;
+    }
+    ::close(fd);
+    return r;
+  }
+
+  /**
+   * Loopback server answering one connection at a time on its own thread, so the handler never runs concurrently
+   */
+  class server {
+    public:
+      using handler = std::function<response(const std::string& path, const std::string& body)>;
+
+      explicit server(handler on_request) : on_request(std::move(on_request))
+      {
+        fd = ::socket(AF_INET, SOCK_STREAM, 0);
+        if (fd < 0) throw error("socket failed");
+        const int reuse = 1;
+        ::setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+        sockaddr_in address = {};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        address.sin_port = 0; // any free port
+        socklen_t length = sizeof(address);
+        if (::bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || ::listen(fd, 64) != 0 ||
+            ::getsockname(fd, reinterpret_cast<sockaddr*>(&address), &length) != 0) {
+          ::close(fd);
+          throw error("Cannot listen on the loopback interface");
+        }
+        bound_port = ntohs(address.sin_port);
+        worker = std::thread([this] { serve(); });
+      }
+
+      ~server()
+      {
+        stopping = true;
+        ::shutdown(fd, SHUT_RDWR);
+        ::close(fd);
+        worker.join();
+      }
+
+      server(const server&) = delete;
+      server& operator=(const server&) = delete;
+
+      std::string url() const { return "http://127.0.0.1:" + std::to_string(bound_port); }
+
+    private:
+      void serve()
+      {
+        while (!stopping) {
+          const int client = ::accept(fd, nullptr, nullptr);
+          if (client < 0) continue;
+          std::string head, body;
+          if (detail::readMessage(client, head, body)) {
+            const size_t start = head.find(' ') + 1;
+            const std::string path = head.substr(start, head.find(' ', start) - start);
+            response r;
+            try {
+              r = on_request(path, body);
+            } catch (const std::exception& e) {
+              r = response { 500, std::string("{\"code\":500,\"message\":\"") + e.what() + "\"}" };
+            }
+            try {
+              detail::sendAll(client, "HTTP/1.1 " + std::to_string(r.status) + (r.status == 200 ? " OK" : " Error") +
+                "\r\nContent-Type: application/json\r\nContent-Length: " + std::to_string(r.body.size()) + "\r\nConnection: close\r\n\r\n" + r.body);
+            } catch (const error&) {
+              // client went away
+            }
+          }
+          ::close(client);
+        }
+      }
+
+      handler on_request;
+      int fd = -1;
+      uint16_t bound_port = 0;
+      std::atomic<bool> stopping { false };
+      std::thread worker;
+  };
+} // namespace http
@@ -0,0 +1,228 @@
+// chain_api over nodeos' HTTP API: get_table_rows reads, transactions signed by keosd & sent with push_transaction
+#pragma once
+
+#include "chain_api.hpp"
+#include "http.hpp"
+#include "json.hpp"
+
+#include <atomic>
+#include <ctime>
+
+namespace relayer
+{
+  //======================== Transactions ========================
+
+  using packed_action = std::tuple<eosio::name, eosio::name, std::vector<std::pair<eosio::name, eosio::name>>, std::vector<char>>;
+
+  // Antelope transaction, as packed into packed_trx
+  struct transaction {
+    uint32_t expiration = 0;
+    uint16_t ref_block_num = 0;
+    uint32_t ref_block_prefix = 0;
+    eosio::unsigned_int max_net_usage_words;
+    uint8_t max_cpu_usage_ms = 0;
+    eosio::unsigned_int delay_sec;
+    std::vector<packed_action> context_free_actions;
+    std::vector<packed_action> actions;
+    std::vector<std::pair<uint16_t, std::vector<char>>> transaction_extensions;
+
+    EOSLIB_SERIALIZE(transaction, (expiration)(ref_block_num)(ref_block_prefix)(max_net_usage_words)(max_cpu_usage_ms)(delay_sec)(context_free_actions)(actions)(transaction_extensions));
+  };
+
+  inline std::vector<uint8_t> hexToBytes(const std::string& hex)
+  {
+    const size_t start = hex.compare(0, 2, "0x") == 0 ? 2 : 0;
+    eosio::check((hex.size() - start) % 2 == 0, "Odd length hex string");
+    std::vector<uint8_t> bytes;
+    for (size_t i = start; i < hex.size(); i += 2) {
+      bytes.push_back(uint8_t(std::stoul(hex.substr(i, 2), nullptr, 16)));
+    }
+    return bytes;
+  }
+
+  // Big endian hex word, as eosio.evm's ABI renders accountstate values
+  inline uint256_t hexToWord(const std::string& hex)
+  {
+    const std::vector<uint8_t> bytes = hexToBytes(hex);
+    eosio::check(bytes.size() <= 32, "Word longer than 32 bytes");
+    std::array<uint8_t, 32u> word = {};
+    std::copy(bytes.begin(), bytes.end(), word.end() - bytes.size());
+    return bytesToValue(word);
+  }
+
+  // nodeos time points, "2023-11-14T22:13:20.000"
+  inline uint32_t parseTime(const std::string& time)
+  {
+    std::tm tm = {};
+    eosio::check(strptime(time.c_str(), "%Y-%m-%dT%H:%M:%S", &tm) != nullptr, "Invalid time " + time);
+    return uint32_t(timegm(&tm));
+  }
+
+  inline std::string formatTime(uint32_t seconds)
+  {
+    const std::time_t t = seconds;
+    std::tm tm = {};
+    gmtime_r(&t, &tm);
+    char buffer[32];
+    std::strftime(buffer, sizeof(buffer), "%Y-%m-%dT%H:%M:%S", &tm);
+    return buffer;
+  }
+
+  //======================== nodeos ========================
+
+  struct http_options {
+    std::string url = "http://127.0.0.1:8888";
+    std::string wallet_url;   // keosd, transactions go unsigned without one
+    std::string public_key;
+    eosio::name actor;
+    eosio::name permission = "active"_n;
+    uint32_t expiration_seconds = 60;
+  };
+
+  class http_chain_api : public chain_api {
+    public:
+      explicit http_chain_api(http_options options)
+        : options(std::move(options)), node(http::endpoint::parse(this->options.url))
+      {
+        if (!this->options.wallet_url.empty()) wallet = http::endpoint::parse(this->options.wallet_url);
+      }
+
+      bridge_info bridge(eosio::name contract) override
+      {
+        json::value request = json::value::object();
+        request["code"] = contract.to_string();
+        request["scope"] = contract.to_string();
+        request["table"] = "bridgeconfig";
+        request["json"] = true;
+        request["limit"] = 1;
+        const json::value rows = call(node, "/v1/chain/get_table_rows", request)["rows"];
+        eosio::check(rows.size() == 1, "Bridge config not found");
+
+        bridge_info info;
+        info.evm_bridge_scope = rows[0]["evm_bridge_scope"].as_uint64();
+
+        // No settings row until the admin sets one, the contract runs on its defaults until then
+        request["table"] = "settings";
+        const json::value settings = call(node, "/v1/chain/get_table_rows", request)["rows"];
+        if (settings.size() == 1) info.notify_max_items = settings[0]["notify_max_items"].as_uint64();
+        return info;
+      }
+
+      // Exact bykey lookup, the bounds are inclusive
+      uint256_t readStorage(uint64_t scope, const eosio::checksum256& key) override
+      {
+        const std::string key_hex = bin2hex(key.extract_as_byte_array());
+        json::value request = json::value::object();
+        request["code"] = EVM_SYSTEM_CONTRACT.to_string();
+        request["scope"] = std::to_string(scope);
+        request["table"] = "accountstate";
+        request["index_position"] = "2";
+        request["key_type"] = "sha256";
+        request["lower_bound"] = key_hex;
+        request["upper_bound"] = key_hex;
+        request["json"] = true;
+        request["limit"] = 1;
+        const json::value rows = call(node, "/v1/chain/get_table_rows", request)["rows"];
+        if (rows.size() == 0) return 0;
+        return hexToWord(rows[0]["value"].as_string());
+      }
+
+      push_result push(eosio::name contract, eosio::name action, const std::vector<char>& data) override
+      {
+        push_result pushed;
+        try {
+          const json::value info = call(node, "/v1/chain/get_info", json::value::object());
+          const std::vector<uint8_t> block_id = hexToBytes(info["last_irreversible_block_id"].as_string());
+          eosio::check(block_id.size() == 32, "Invalid block id");
+
+          transaction tx;
+          // Identical notify actions pipelined within a block need distinct ids, so each one gets its own expiration
+          tx.expiration = parseTime(info["head_block_time"].as_string()) + options.expiration_seconds + uint32_t(sequence++ % 600);
+          tx.ref_block_num = uint16_t((uint32_t(block_id[2]) << 8) | block_id[3]);
+          memcpy(&tx.ref_block_prefix, block_id.data() + 8, sizeof(tx.ref_block_prefix));
+          tx.actions.push_back(packed_action(contract, action, { { options.actor, options.permission } }, data));
+
+          json::value signatures = json::value::array();
+          if (wallet.host.size()) signatures = sign(tx, info["chain_id"].as_string())["signatures"];
+
+          const std::vector<char> packed = eosio::pack(tx);
+          json::value request = json::value::object();
+          request["signatures"] = signatures;
+          request["compression"] = 0;
+          request["packed_context_free_data"] = "";
+          request["packed_trx"] = bin2hex(std::vector<uint8_t>(packed.begin(), packed.end()));
+          const json::value sent = call(node, "/v1/chain/push_transaction", request);
+
+          pushed.transaction_id = sent["transaction_id"].as_string();
+          const std::vector<uint8_t> returned = hexToBytes(sent["processed"]["action_traces"][0]["return_value_hex_data"].as_string());
+          pushed.result = eosio::unpack<notify_result>(reinterpret_cast<const char*>(returned.data()), returned.size());
+          pushed.ok = true;
+        } catch (const std::exception& e) {
+          pushed.error = e.what();
+        }
+        return pushed;
+      }
+
+    private:
+      // keosd signs the JSON form of the transaction
+      json::value sign(const transaction& tx, const std::string& chain_id)
+      {
+        json::value authorization = json::value::array();
+        json::value level = json::value::object();
+        level["actor"] = options.actor.to_string();
+        level["permission"] = options.permission.to_string();
+        authorization.push_back(level);
+
+        json::value actions = json::value::array();
+        for (const auto& a : tx.actions) {
+          json::value action = json::value::object();
+          action["account"] = std::get<0>(a).to_string();
+          action["name"] = std::get<1>(a).to_string();
+          action["authorization"] = authorization;
+          const std::vector<char>& data = std::get<3>(a);
+          action["data"] = bin2hex(std::vector<uint8_t>(data.begin(), data.end()));
+          actions.push_back(action);
+        }
+
+        json::value unsigned_tx = json::value::object();
+        unsigned_tx["expiration"] = formatTime(tx.expiration);
+        unsigned_tx["ref_block_num"] = int(tx.ref_block_num);
+        unsigned_tx["ref_block_prefix"] = uint64_t(tx.ref_block_prefix);
+        unsigned_tx["max_net_usage_words"] = 0;
+        unsigned_tx["max_cpu_usage_ms"] = 0;
+        unsigned_tx["delay_sec"] = 0;
+        unsigned_tx["context_free_actions"] = json::value::array();
+        unsigned_tx["actions"] = actions;
+        unsigned_tx["transaction_extensions"] = json::value::array();
+
+        json::value keys = json::value::array();
+        keys.push_back(options.public_key);
+        json::value request = json::value::array();
+        request.push_back(unsigned_tx);
+        request.push_back(keys);
+        request.push_back(chain_id);
+        return call(wallet, "/v1/wallet/sign_transaction", request);
+      }
+
+      // nodeos errors come back as {"code": 500, "error": {"details": [{"message": "assertion failure with message: ..."}]}}
+      static json::value call(const http::endpoint& to, const std::string& path, const json::value& request)
+      {
+        const http::response r = http::post(to, path, request.dump());
+        const json::value body = json::value::parse(r.body);
+        if (r.status == 200) return body;
+
+        std::string message = "HTTP " + std::to_string(r.status) + " from " + path;
+        if (body.has("error") && body["error"].has("details") && body["error"]["details"].size() > 0) {
+          message += ": " + body["error"]["details"][0]["message"].as_string();
+        } else if (body.has("message")) {
+          message += ": " + body["message"].as_string();
+        }
+        throw http::error(message);
+      }
+
+      http_options options;
+      http::endpoint node;
+      http::endpoint wallet;
+      std::atomic<uint64_t> sequence { 0 };
+  };
+} // namespace relayer
@@ -0,0 +1,272 @@
+// Minimal JSON value, parser & writer for the chain API requests & responses
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace json
+{
+  struct parse_error : std::runtime_error {
+    using std::runtime_error::runtime_error;
+  };
+
+  class value {
+    public:
+      enum class kind { null, boolean, number, string, array, object };
+
+      value() = default;
+      value(std::nullptr_t) {}
+      value(bool b) : type(kind::boolean), boolean(b) {}
+      value(int n) : type(kind::number), text(std::to_string(n)) {}
+      value(int64_t n) : type(kind::number), text(std::to_string(n)) {}
+      value(uint64_t n) : type(kind::number), text(std::to_string(n)) {}
+      value(const char* s) : type(kind::string), text(s) {}
+      value(std::string s) : type(kind::string), text(std::move(s)) {}
+
+      static value array() { value v; v.type = kind::array; return v; }
+      static value object() { value v; v.type = kind::object; return v; }
+
+      // Numbers keep their text so 64 bits integers round trip exactly
+      static value number(std::string digits) { value v; v.type = kind::number; v.text = std::move(digits); return v; }
+
+      kind type_of() const { return type; }
+      bool is_null() const { return type == kind::null; }
+      bool is_object() const { return type == kind::object; }
+      bool is_array() const { return type == kind::array; }
+
+      bool as_bool() const { expect(kind::boolean); return boolean; }
+      const std::string& as_string() const { expect(kind::string); return text; }
+
+      // Numbers & numeric strings, nodeos sends 64 bits integers either way
+      uint64_t as_uint64() const
+      {
+        if (type != kind::number && type != kind::string) expect(kind::number);
+        return std::stoull(text);
+      }
+
+      value& operator[](const std::string& key)
+      {
+        if (type == kind::null) type = kind::object;
+        expect(kind::object);
+        for (auto& member : members) {
+          if (member.first == key) return member.second;
+        }
+        members.emplace_back(key, value());
+        return members.back().second;
+      }
+
+      const value& operator[](const std::string& key) const
+      {
+        expect(kind::object);
+        for (const auto& member : members) {
+          if (member.first == key) return member.second;
+        }
+        throw parse_error("missing member " + key);
+      }
+
+      bool has(const std::string& key) const
+      {
+        if (type != kind::object) return false;
+        for (const auto& member : members) {
+          if (member.first == key) return true;
+        }
+        return false;
+      }
+
+      const value& operator[](size_t i) const { expect(kind::array); return items.at(i); }
+      size_t size() const { return type == kind::array ? items.size() : members.size(); }
+
+      value& push_back(value v)
+      {
+        if (type == kind::null) type = kind::array;
+        expect(kind::array);
+        items.push_back(std::move(v));
+        return items.back();
+      }
+
+      std::string dump() const
+      {
+        std::string out;
+        write(out);
+        return out;
+      }
+
+      static value parse(const std::string& text)
+      {
+        size_t pos = 0;
+        value v = parseValue(text, pos);
+        skipSpaces(text, pos);
+        if (pos != text.size()) throw parse_error("trailing characters");
+        return v;
+      }
+
+    private:
+      void expect(kind k) const
+      {
+        if (type != k) throw parse_error("unexpected JSON type");
+      }
+
+      static void writeString(std::string& out, const std::string& s)
+      {
+        out += '"';
+        for (const char c : s) {
+          switch (c) {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default:
+              if (static_cast<unsigned char>(c) < 0x20) {
+                char escaped[8];
+                std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+                out += escaped;
+              } else {
+                out += c;
+              }
+          }
+        }
+        out += '"';
+      }
+
+      void write(std::string& out) const
+      {
+        switch (type) {
+          case kind::null: out += "null"; break;
+          case kind::boolean: out += boolean ? "true" : "false"; break;
+          case kind::number: out += text; break;
+          case kind::string: writeString(out, text); break;
+          case kind::array:
+            out += '[';
+            for (size_t i = 0; i < items.size(); i++) {
+              if (i) out += ',';
+              items[i].write(out);
+            }
+            out += ']';
+            break;
+          case kind::object:
+            out += '{';
+            for (size_t i = 0; i < members.size(); i++) {
+              if (i) out += ',';
+              writeString(out, members[i].first);
+              out += ':';
+              members[i].second.write(out);
+            }
+            out += '}';
+            break;
+        }
+      }
+
+      static void skipSpaces(const std::string& s, size_t& pos)
+      {
+        while (pos < s.size() && (s[pos] == ' ' || s[pos] == '\n' || s[pos] == '\r' || s[pos] == '\t')) pos++;
+      }
+
+      static void consume(const std::string& s, size_t& pos, const char* literal)
+      {
+        for (; *literal; literal++, pos++) {
+          if (pos >= s.size() || s[pos] != *literal) throw parse_error("invalid literal");
+        }
+      }
+
+      static std::string parseString(const std::string& s, size_t& pos)
+      {
+        std::string out;
+        pos++; // opening quote
+        while (pos < s.size() && s[pos] != '"') {
+          char c = s[pos++];
+          if (c != '\\') {
+            out += c;
+            continue;
+          }
+          if (pos >= s.size()) break;
+          c = s[pos++];
+          switch (c) {
+            case 'n': out += '\n'; break;
+            case 'r': out += '\r'; break;
+            case 't': out += '\t'; break;
+            case 'b': out += '\b'; break;
+            case 'f': out += '\f'; break;
+            case 'u': {
+              if (pos + 4 > s.size()) throw parse_error("invalid escape");
+              const unsigned code = std::stoul(s.substr(pos, 4), nullptr, 16);
+              pos += 4;
+              if (code < 0x80) {
+                out += char(code);
+              } else if (code < 0x800) {
+                out += char(0xc0 | (code >> 6));
+                out += char(0x80 | (code & 0x3f));
+              } else {
+                out += char(0xe0 | (code >> 12));
+                out += char(0x80 | ((code >> 6) & 0x3f));
+                out += char(0x80 | (code & 0x3f));
+              }
+              break;
+            }
+            default: out += c;
+          }
+        }
+        if (pos >= s.size()) throw parse_error("unterminated string");
+        pos++; // closing quote
+        return out;
+      }
+
+      static value parseValue(const std::string& s, size_t& pos)
+      {
+        skipSpaces(s, pos);
+        if (pos >= s.size()) throw parse_error("unexpected end of JSON");
+        const char c = s[pos];
+        if (c == '{') {
+          value v = object();
+          pos++;
+          skipSpaces(s, pos);
+          if (pos < s.size() && s[pos] == '}') { pos++; return v; }
+          while (true) {
+            skipSpaces(s, pos);
+            if (pos >= s.size() || s[pos] != '"') throw parse_error("expected a key");
+            std::string key = parseString(s, pos);
+            skipSpaces(s, pos);
+            consume(s, pos, ":");
+            v.members.emplace_back(std::move(key), parseValue(s, pos));
+            skipSpaces(s, pos);
+            if (pos < s.size() && s[pos] == ',') { pos++; continue; }
+            consume(s, pos, "}");
+            return v;
+          }
+        }
+        if (c == '[') {
+          value v = array();
+          pos++;
+          skipSpaces(s, pos);
+          if (pos < s.size() && s[pos] == ']') { pos++; return v; }
+          while (true) {
+            v.items.push_back(parseValue(s, pos));
+            skipSpaces(s, pos);
+            if (pos < s.size() && s[pos] == ',') { pos++; continue; }
+            consume(s, pos, "]");
+            return v;
+          }
+        }
+        if (c == '"') return value(parseString(s, pos));
+        if (c == 't') { consume(s, pos, "true"); return value(true); }
+        if (c == 'f') { consume(s, pos, "false"); return value(false); }
+        if (c == 'n') { consume(s, pos, "null"); return value(); }
+
+        const size_t start = pos;
+        while (pos < s.size() && (isdigit(static_cast<unsigned char>(s[pos])) || s[pos] == '-' || s[pos] == '+' || s[pos] == '.' || s[pos] == 'e' || s[pos] == 'E')) pos++;
+        if (start == pos) throw parse_error("invalid JSON value");
+        return number(s.substr(start, pos - start));
+      }
+
+      kind type = kind::null;
+      bool boolean = false;
+      std::string text;
+      std::vector<value> items;
+      std::vector<std::pair<std::string, value>> members;
+  };
+} // namespace json
@@ -0,0 +1,60 @@
+// Relayer daemon, replaces the reqnotify.sh cron: pushes reqnotify & refundnotify only when TokenBridge has queued work
+// Build with CMake from antelope/, then run ./relayer --url <nodeos> --wallet-url <keosd> --key <public key> --actor <account>
+//   [--contract token.brdg] [--permission active] [--max-inflight 4] [--min-interval-ms 250] [--max-interval-ms 10000] [--report-interval-s 60]
+//   [--shard <id>/<count>], each relayer of a group cranking its own shard of the queues
+
+#include "http_chain_api.hpp"
+#include "relayer.hpp"
+
+#include <csignal>
+#include <cstdlib>
+
+namespace
+{
+  std::atomic<bool> stop { false };
+
+  void onSignal(int) { stop = true; }
+}
+
+int main(int argc, char** argv)
+{
+  relayer::http_options chain;
+  relayer::options opts;
+  unsigned long long shard_id = 0, shard_count = 1;
+  for (int i = 1; i < argc; i++) {
+    const std::string arg = argv[i];
+    const bool has_value = i + 1 < argc;
+    if (arg == "--url" && has_value) chain.url = argv[++i];
+    else if (arg == "--wallet-url" && has_value) chain.wallet_url = argv[++i];
+    else if (arg == "--key" && has_value) chain.public_key = argv[++i];
+    else if (arg == "--actor" && has_value) chain.actor = eosio::name(argv[++i]);
+    else if (arg == "--permission" && has_value) chain.permission = eosio::name(argv[++i]);
+    else if (arg == "--contract" && has_value) opts.contract = eosio::name(argv[++i]);
+    else if (arg == "--max-inflight" && has_value) opts.max_inflight = std::max<uint64_t>(std::strtoull(argv[++i], nullptr, 10), 1);
+    else if (arg == "--min-interval-ms" && has_value) opts.min_interval = std::chrono::milliseconds(std::strtoull(argv[++i], nullptr, 10));
+    else if (arg == "--max-interval-ms" && has_value) opts.max_interval = std::chrono::milliseconds(std::strtoull(argv[++i], nullptr, 10));
+    else if (arg == "--report-interval-s" && has_value) opts.report_interval = std::chrono::seconds(std::strtoull(argv[++i], nullptr, 10));
+    else if (arg == "--shard" && has_value && std::sscanf(argv[++i], "%llu/%llu", &shard_id, &shard_count) == 2 && shard_id < shard_count) {
+      opts.shard_id = shard_id;
+      opts.shard_count = shard_count;
+    }
+    else {
+      std::fprintf(stderr, "usage: %s --url <nodeos> [--wallet-url <keosd> --key <public key>] --actor <account> [--permission <name>] [--contract <name>]\n"
+        "  [--max-inflight <n>] [--min-interval-ms <ms>] [--max-interval-ms <ms>] [--report-interval-s <s>] [--shard <id>/<count>]\n", argv[0]);
+      return 1;
+    }
+  }
+  if (chain.actor == eosio::name()) chain.actor = opts.contract;
+
+  std::signal(SIGINT, onSignal);
+  std::signal(SIGTERM, onSignal);
+  try {
+    relayer::http_chain_api api(chain);
+    relayer::relayer r(api, opts);
+    r.run(stop);
+  } catch (const std::exception& e) {
+    std::fprintf(stderr, "relayer: %s\n", e.what());
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,173 @@
+// Offline nodeos & keosd for the relayer: the chain & wallet HTTP endpoints it uses, answered by the contract
+// running against the in memory emulator, EVM callbacks settled as eosio.evm would within the same transaction
+// Include after the contract source
+#pragma once
+
+#include "../emulator/bridge_fixture.hpp"
+#include "http_chain_api.hpp"
+
+#include <mutex>
+#include <set>
+
+namespace relayer
+{
+  class mock_node {
+    public:
+      explicit mock_node(emulator::bridge_fixture& bridge)
+        : bridge(bridge), server([this](const std::string& path, const std::string& body) { return handle(path, body); }) {}
+
+      std::string url() const { return server.url(); }
+
+      // The next `count` pushes are rejected, as a node dropping transactions would
+      void failPushes(uint64_t count) { std::lock_guard<std::mutex> lock(mutex); failures_left = count; }
+
+      // Queues more bridge requests & refunds on EVM while the relayer runs
+      void queue(uint64_t count) { std::lock_guard<std::mutex> lock(mutex); bridge.queue(count); }
+
+      uint64_t pushed() const { std::lock_guard<std::mutex> lock(mutex); return pushes; }
+
+      // Cumulative host calls of every pushed transaction
+      eosio::native::host_counters counters() const { std::lock_guard<std::mutex> lock(mutex); return total; }
+
+    private:
+      http::response handle(const std::string& path, const std::string& body)
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        const json::value request = json::value::parse(body);
+        if (path == "/v1/chain/get_info") return ok(info());
+        if (path == "/v1/chain/get_table_rows") return ok(tableRows(request));
+        if (path == "/v1/wallet/sign_transaction") {
+          json::value signed_tx = request[0];
+          signed_tx["signatures"] = json::value::array();
+          signed_tx["signatures"].push_back("SIG_K1_mock");
+          return ok(signed_tx);
+        }
+        if (path == "/v1/chain/push_transaction") return pushTransaction(request);
+        return error(404, "Unknown endpoint " + path);
+      }
+
+      json::value info() const
+      {
+        const uint32_t now = uint32_t(eosio::native::host().now.sec_since_epoch());
+        json::value info = json::value::object();
+        info["chain_id"] = std::string(64, '0');
+        info["head_block_num"] = uint64_t(now);
+        info["head_block_time"] = formatTime(now) + ".000";
+        info["last_irreversible_block_id"] = bin2hex(toBin(uint256_t(now) << 224));
+        return info;
+      }
+
+      json::value tableRows(const json::value& request) const
+      {
+        json::value result = json::value::object();
+        json::value& rows = result["rows"] = json::value::array();
+        const std::string table = request["table"].as_string();
+        if (table == "bridgeconfig") {
+          config_singleton_bridge config(bridge_fixture::SELF, bridge_fixture::SELF.value);
+          const auto conf = config.get();
+          json::value row = json::value::object();
+          row["evm_bridge_scope"] = conf.evm_bridge_scope;
+          rows.push_back(row);
+        } else if (table == "settings") {
+          settings_singleton settings(bridge_fixture::SELF, bridge_fixture::SELF.value);
+          if (settings.exists()) {
+            json::value row = json::value::object();
+            row["notify_max_items"] = settings.get().notify_max_items;
+            rows.push_back(row);
+          }
+        } else if (table == "accountstate") {
+          std::array<uint8_t, 32u> key = {};
+          const std::vector<uint8_t> bytes = hexToBytes(request["lower_bound"].as_string());
+          std::copy(bytes.begin(), bytes.end(), key.begin());
+          account_state_table states(EVM_SYSTEM_CONTRACT, std::stoull(request["scope"].as_string()));
+          auto by_key = states.get_index<"bykey"_n>();
+          const auto state = by_key.find(eosio::checksum256(key));
+          if (state != by_key.end()) {
+            json::value row = json::value::object();
+            row["index"] = state->index;
+            row["key"] = bin2hex(key);
+            row["value"] = bin2hex(toBin(state->value));
+            rows.push_back(row);
+          }
+        }
+        return result;
+      }
+
+      http::response pushTransaction(const json::value& request)
+      {
+        const std::string packed_hex = request["packed_trx"].as_string();
+        if (failures_left > 0) {
+          failures_left--;
+          return error(500, "transaction dropped by the mock");
+        }
+        if (!seen.insert(packed_hex).second) return error(409, "Duplicate transaction");
+
+        const std::vector<uint8_t> packed = hexToBytes(packed_hex);
+        const auto tx = eosio::unpack<transaction>(reinterpret_cast<const char*>(packed.data()), packed.size());
+        eosio::check(tx.actions.size() == 1, "The mock runs single action transactions");
+        const eosio::name action = std::get<1>(tx.actions[0]);
+        const std::vector<char>& data = std::get<3>(tx.actions[0]);
+        const auto [shard_id, shard_count] = eosio::unpack<std::tuple<uint64_t, uint64_t>>(data.data(), data.size());
+
+        notify_result result { 0, 0 };
+        emulator::measurement m;
+        try {
+          auto c = bridge_fixture::contract();
+          if (action == "reqnotify"_n) m = emulator::measure([&] { result = c.reqnotify(shard_id, shard_count); });
+          else if (action == "refundnotify"_n) m = emulator::measure([&] { result = c.refundnotify(shard_id, shard_count); });
+          else return error(500, "Unknown action " + action.to_string());
+        } catch (const eosio::eosio_assert_exception& e) {
+          return error(500, std::string("assertion failure with message: ") + e.what());
+        }
+        bridge.settle(m.actions);
+        add(m.counters);
+        pushes++;
+        eosio::native::host().now = eosio::native::host().now + eosio::milliseconds(500);
+
+        const std::vector<char> returned = eosio::pack(result);
+        json::value trace = json::value::object();
+        trace["return_value_hex_data"] = bin2hex(std::vector<uint8_t>(returned.begin(), returned.end()));
+        json::value response = json::value::object();
+        response["transaction_id"] = bin2hex(toBin(uint256_t(pushes)));
+        response["processed"]["action_traces"] = json::value::array();
+        response["processed"]["action_traces"].push_back(trace);
+        return ok(response);
+      }
+
+      void add(const eosio::native::host_counters& c)
+      {
+        total.db_find += c.db_find; total.db_lowerbound += c.db_lowerbound; total.db_upperbound += c.db_upperbound;
+        total.db_next += c.db_next; total.db_previous += c.db_previous; total.db_get += c.db_get;
+        total.db_store += c.db_store; total.db_update += c.db_update; total.db_remove += c.db_remove;
+        total.idx_find += c.idx_find; total.idx_lowerbound += c.idx_lowerbound; total.idx_upperbound += c.idx_upperbound;
+        total.idx_next += c.idx_next; total.idx_previous += c.idx_previous;
+        total.bytes_read += c.bytes_read; total.bytes_written += c.bytes_written;
+        total.inline_actions += c.inline_actions; total.inline_bytes += c.inline_bytes;
+      }
+
+      static http::response ok(const json::value& body) { return http::response { 200, body.dump() }; }
+
+      // nodeos' error body
+      static http::response error(int status, const std::string& message)
+      {
+        json::value body = json::value::object();
+        body["code"] = status;
+        body["message"] = "Internal Service Error";
+        json::value detail = json::value::object();
+        detail["message"] = message;
+        body["error"]["details"] = json::value::array();
+        body["error"]["details"].push_back(detail);
+        return http::response { status, body.dump() };
+      }
+
+      using bridge_fixture = emulator::bridge_fixture;
+
+      emulator::bridge_fixture& bridge;
+      mutable std::mutex mutex;
+      uint64_t failures_left = 0;
+      uint64_t pushes = 0;
+      eosio::native::host_counters total;
+      std::set<std::string> seen;
+      http::server server;
+  };
+} // namespace relayer
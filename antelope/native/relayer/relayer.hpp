@@ -0,0 +1,227 @@
+// Polls TokenBridge's requests[] & refunds[] lengths and pushes reqnotify / refundnotify only when there is work,
+// with several transactions in flight while a backlog drains and an adaptive backoff while idle
+#pragma once
+
+#include "chain_api.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <deque>
+#include <future>
+
+namespace relayer
+{
+  using clock = std::chrono::steady_clock;
+
+  struct options {
+    eosio::name contract = "token.brdg"_n;
+    uint64_t max_inflight = 4;                              // transactions in flight per queue
+    uint64_t shard_id = 0;                                  // the queue items this relayer pays out: ids equal to shard_id
+    uint64_t shard_count = 1;                               // modulo shard_count, one shard per relayer
+    std::chrono::milliseconds min_interval { 250 };         // poll interval while there is work
+    std::chrono::milliseconds max_interval { 10000 };       // poll interval ceiling while idle
+    std::chrono::milliseconds report_interval { 60000 };
+  };
+
+  struct queue_metrics {
+    uint64_t pushes = 0;
+    uint64_t empty_pushes = 0;  // pushes that processed nothing
+    uint64_t failures = 0;
+    uint64_t processed = 0;
+    uint64_t latency_us_total = 0;
+    uint64_t latency_us_max = 0;
+
+    double meanLatencyMs() const { return pushes > failures ? latency_us_total / 1000.0 / (pushes - failures) : 0; }
+  };
+
+  struct metrics {
+    uint64_t polls = 0;
+    uint64_t storage_reads = 0;
+    queue_metrics requests;
+    queue_metrics refunds;
+    clock::time_point started = clock::now();
+
+    double throughput() const
+    {
+      const double seconds = std::chrono::duration<double>(clock::now() - started).count();
+      return seconds > 0 ? (requests.processed + refunds.processed) / seconds : 0;
+    }
+  };
+
+  /**
+   * The relayer loop, the chain behind it is pluggable so the same loop runs against nodeos or an offline mock
+   */
+  class relayer {
+    public:
+      relayer(chain_api& chain, options opts)
+        : chain(chain), opts(opts), interval(opts.min_interval),
+          requests { "reqnotify"_n, STORAGE_BRIDGE_REQUEST_INDEX, &stats.requests },
+          refunds { "refundnotify"_n, STORAGE_BRIDGE_REFUND_INDEX, &stats.refunds } {}
+
+      // Polls & pushes until `stop` is set, reporting metrics every report_interval
+      void run(const std::atomic<bool>& stop)
+      {
+        clock::time_point last_report = clock::now();
+        while (!stop) {
+          try {
+            step();
+          } catch (const std::exception& e) {
+            // Node unreachable or answering garbage, keep backing off until it recovers
+            std::fprintf(stderr, "poll failed: %s\n", e.what());
+            interval = std::min(interval * 2, opts.max_interval);
+          }
+          wait();
+          if (clock::now() - last_report >= opts.report_interval) {
+            report(stdout);
+            last_report = clock::now();
+          }
+        }
+        drainInflight();
+        report(stdout);
+      }
+
+      /**
+       * One poll: collects finished pushes, reads both array lengths & tops up the pushes in flight
+       * Returns whether there is still work pending or in flight
+       */
+      bool step()
+      {
+        if (!bridge_read) {
+          bridge = chain.bridge(opts.contract);
+          bridge_read = true;
+        }
+        stats.polls++;
+        const bool requests_busy = poll(requests);
+        const bool refunds_busy = poll(refunds);
+        const bool busy = requests_busy || refunds_busy;
+
+        // Back off exponentially while there is nothing to do or pushes fail, come back to the minimum as soon as they go through
+        const bool failing = requests.failing || refunds.failing;
+        interval = busy && !failing ? opts.min_interval : std::min(interval * 2, opts.max_interval);
+        return busy;
+      }
+
+      // Waits for every push in flight, so the metrics account for all of them
+      void drainInflight()
+      {
+        for (queue* q : { &requests, &refunds }) {
+          while (!q->inflight.empty()) {
+            q->inflight.front().wait();
+            collect(*q);
+          }
+        }
+      }
+
+      std::chrono::milliseconds currentInterval() const { return interval; }
+      const metrics& current() const { return stats; }
+
+      void report(FILE* out) const
+      {
+        const auto line = [&](const char* action, const queue_metrics& q) {
+          std::fprintf(out, "%-12s pushes %llu empty %llu failed %llu processed %llu latency mean %.1f ms max %.1f ms\n", action,
+            (unsigned long long)q.pushes, (unsigned long long)q.empty_pushes, (unsigned long long)q.failures, (unsigned long long)q.processed,
+            q.meanLatencyMs(), q.latency_us_max / 1000.0);
+        };
+        std::fprintf(out, "polls %llu storage reads %llu throughput %.1f items/s\n", (unsigned long long)stats.polls,
+          (unsigned long long)stats.storage_reads, stats.throughput());
+        line("reqnotify", stats.requests);
+        line("refundnotify", stats.refunds);
+        std::fflush(out);
+      }
+
+    private:
+      struct inflight_push {
+        std::future<push_result> result;
+        clock::time_point sent;
+
+        void wait() const { result.wait(); }
+        bool ready() const { return result.wait_for(std::chrono::seconds(0)) == std::future_status::ready; }
+      };
+
+      struct queue {
+        eosio::name action;
+        uint8_t storage_index;
+        queue_metrics* metrics;
+        std::deque<inflight_push> inflight {};
+        uint64_t length = 0;          // last polled array length
+        uint64_t stalled_length = 0;  // length at which a push processed nothing while items were pending
+        bool stalled = false;
+        bool failing = false;         // the last push failed, only one probe goes out until one succeeds
+      };
+
+      bool poll(queue& q)
+      {
+        while (!q.inflight.empty() && q.inflight.front().ready()) collect(q);
+
+        q.length = static_cast<uint64_t>(chain.readStorage(bridge.evm_bridge_scope, toChecksum256(q.storage_index)));
+        stats.storage_reads++;
+
+        // The contract could not process the head of the queue (budget, missing pair...), wait for it to change
+        if (q.stalled && q.length == q.stalled_length) return !q.inflight.empty();
+        q.stalled = false;
+
+        // Each push processes up to notify_max_items of this relayer's shard, the ones in flight cover the first part of it
+        const uint64_t per_push = std::max<uint64_t>(bridge.notify_max_items, 1);
+        const uint64_t shard_length = (q.length + opts.shard_count - 1) / opts.shard_count;
+        const uint64_t needed = (shard_length + per_push - 1) / per_push;
+        const uint64_t max_inflight = q.failing ? 1 : opts.max_inflight;
+        while (q.inflight.size() < std::min(needed, max_inflight)) {
+          const eosio::name action = q.action;
+          const std::vector<char> data = eosio::pack(std::make_tuple(opts.shard_id, opts.shard_count));
+          q.inflight.push_back(inflight_push {
+            std::async(std::launch::async, [this, action, data] { return chain.push(opts.contract, action, data); }),
+            clock::now()
+          });
+          q.metrics->pushes++;
+        }
+        return q.length > 0 || !q.inflight.empty();
+      }
+
+      void collect(queue& q)
+      {
+        inflight_push done = std::move(q.inflight.front());
+        q.inflight.pop_front();
+        const push_result pushed = done.result.get();
+        q.failing = !pushed.ok;
+        if (!pushed.ok) {
+          q.metrics->failures++;
+          std::fprintf(stderr, "%s failed: %s\n", q.action.to_string().c_str(), pushed.error.c_str());
+          return;
+        }
+
+        const uint64_t latency = std::chrono::duration_cast<std::chrono::microseconds>(clock::now() - done.sent).count();
+        q.metrics->latency_us_total += latency;
+        q.metrics->latency_us_max = std::max(q.metrics->latency_us_max, latency);
+        q.metrics->processed += pushed.result.processed;
+        // Nothing processed: the head of the queue is stuck or the items left belong to other shards, wait for the length to change
+        if (pushed.result.processed == 0) {
+          q.metrics->empty_pushes++;
+          q.stalled = true;
+          q.stalled_length = q.length;
+        }
+      }
+
+      void wait()
+      {
+        // While pushes are in flight, wake up as soon as the oldest one lands
+        for (queue* q : { &requests, &refunds }) {
+          if (!q->inflight.empty()) {
+            q->inflight.front().result.wait_for(interval);
+            return;
+          }
+        }
+        std::this_thread::sleep_for(interval);
+      }
+
+      chain_api& chain;
+      options opts;
+      bridge_info bridge;
+      bool bridge_read = false;
+      metrics stats;
+      std::chrono::milliseconds interval;
+      queue requests;
+      queue refunds;
+  };
+} // namespace relayer
@@ -0,0 +1,108 @@
+// Runs the relayer against the mock node over loopback HTTP: it must drain both queues, push nothing once they are
+// empty, back off while idle & recover from dropped transactions
+
+#include "../../src/token.brdg.cpp"
+
+#include "mock_node.hpp"
+#include "relayer.hpp"
+
+#include <cstdio>
+
+using namespace evm_bridge;
+
+namespace
+{
+  constexpr uint64_t MAX_STEPS = 10000;
+
+  void expect(bool condition, const char* message)
+  {
+    if (!condition) {
+      std::fprintf(stderr, "FAILED: %s\n", message);
+      std::exit(1);
+    }
+  }
+
+  // Steps until the relayer reports nothing left to do, then waits for the pushes still in flight
+  void runUntilIdle(relayer::relayer& r)
+  {
+    uint64_t steps = 0;
+    while (r.step() && steps++ < MAX_STEPS) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    r.drainInflight();
+    expect(steps < MAX_STEPS, "relayer did not go idle");
+  }
+}
+
+int main()
+{
+  constexpr uint64_t DEPTH = 120;
+  constexpr uint64_t MAX_ITEMS = 8;
+
+  emulator::bridge_fixture bridge(3, MAX_ITEMS);
+  relayer::mock_node node(bridge);
+  relayer::http_options chain;
+  chain.url = node.url();
+  chain.wallet_url = node.url();
+  chain.public_key = "PUB_K1_mock";
+  chain.actor = emulator::bridge_fixture::SELF;
+  relayer::http_chain_api api(chain);
+
+  relayer::options opts;
+  opts.max_inflight = 4;
+  opts.min_interval = std::chrono::milliseconds(1);
+  opts.max_interval = std::chrono::milliseconds(8);
+  relayer::relayer r(api, opts);
+
+  // Empty queues: nothing is pushed (refundnotify would even fail on a missing refunds[] length) & the interval backs off
+  for (int i = 0; i < 5; i++) r.step();
+  expect(node.pushed() == 0 && r.current().requests.pushes == 0 && r.current().refunds.pushes == 0, "pushed with empty queues");
+  expect(r.currentInterval() == opts.max_interval, "idle polling did not back off");
+
+  // Backlog: drained with several transactions in flight, a few of them dropped by the node on the way
+  node.queue(DEPTH);
+  node.failPushes(3);
+  runUntilIdle(r);
+  r.report(stdout);
+
+  const auto& m = r.current();
+  expect(m.requests.processed == DEPTH && m.refunds.processed == DEPTH, "queues not drained");
+  expect(m.requests.failures + m.refunds.failures == 3, "dropped pushes not reported");
+  expect(bridge.requests.length() == 0 && bridge.refunds.length() == 0, "EVM arrays not emptied");
+  expect(m.requests.pushes - m.requests.failures >= DEPTH / MAX_ITEMS, "fewer pushes than the backlog needs");
+  expect(r.currentInterval() <= opts.min_interval * 2, "busy polling backed off");
+
+  // The contract's own stats agree with the relayer's
+  const auto totals = emulator::bridge_fixture::statsTotals();
+  expect(totals.requests_processed == DEPTH && totals.refunds_processed == DEPTH, "contract stats do not match");
+
+  // Idle again: no more pushes
+  const uint64_t pushed = node.pushed();
+  for (int i = 0; i < 5; i++) r.step();
+  expect(node.pushed() == pushed, "pushed with drained queues");
+
+  // Two relayers splitting the queues into shards: each pays out its own half, together they drain both queues
+  relayer::options shard_opts = opts;
+  shard_opts.shard_count = 2;
+  relayer::relayer first(api, shard_opts);
+  shard_opts.shard_id = 1;
+  relayer::relayer second(api, shard_opts);
+  node.queue(DEPTH);
+  uint64_t steps = 0;
+  while ((first.step() | second.step()) && steps++ < MAX_STEPS) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  first.drainInflight();
+  second.drainInflight();
+  expect(steps < MAX_STEPS, "sharded relayers did not go idle");
+  const auto& a = first.current();
+  const auto& b = second.current();
+  expect(a.requests.processed + b.requests.processed == DEPTH && a.refunds.processed + b.refunds.processed == DEPTH, "shards did not drain the queues");
+  expect(a.requests.processed > 0 && b.requests.processed > 0, "a shard paid out nothing");
+  expect(bridge.requests.length() == 0 && bridge.refunds.length() == 0, "EVM arrays not emptied by the shards");
+  expect(emulator::bridge_fixture::statsTotals().requests_processed == 2 * DEPTH, "shards paid an item twice");
+
+  std::printf("relayer drained %llu requests & %llu refunds in %llu transactions\n", (unsigned long long)m.requests.processed,
+    (unsigned long long)m.refunds.processed, (unsigned long long)node.pushed());
+  return 0;
+}
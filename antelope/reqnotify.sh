@@ -6,4 +6,4 @@ then
 else
   url="https://testnet.telos.caleos.io"
 fi
-cleos --url "$url" push action token.brdg reqnotify '{}' -p token.brdg
+cleos --url "$url" push action token.brdg reqnotify '{"shard_id": 0, "shard_count": 1}' -p token.brdg
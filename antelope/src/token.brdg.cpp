@@ -3,7 +3,7 @@
 // @contract token.brdg
 // @version v1.0
 
-#include "../include/token.brdg.hpp";
+#include "../include/token.brdg.hpp"
 
 namespace evm_bridge
 {
@@ -63,8 +63,27 @@ namespace evm_bridge
         auto account_bridge = accounts_byaddress.find(pad160(bridge_address));
         auto account_register = accounts_byaddress.find(pad160(register_address));
 
-        // Save
+        // Another TokenBridge starts its ids over at 0: the dedupe rows & scan cursors of the old one would skip them
         auto stored = config_bridge.get();
+        if(stored.evm_bridge_address != bridge_address){
+            requests_table requests(get_self(), get_self().value);
+            refunds_table refunds(get_self(), get_self().value);
+            check(requests.begin() == requests.end() && refunds.begin() == refunds.end(), "Erase the legacy requests & refunds rows with droplegacy before moving to another TokenBridge");
+            deposits_table deposits(get_self(), get_self().value);
+            check(deposits.begin() == deposits.end(), "Flush the queued deposits before moving to another TokenBridge");
+            for(const eosio::name queue : { "requests"_n, "refunds"_n }){
+                dedupe_table dedupe(get_self(), queue.value);
+                for(auto itr = dedupe.begin(); itr != dedupe.end();){
+                    itr = dedupe.erase(itr);
+                }
+                notify_scans_table scans(get_self(), queue.value);
+                for(auto itr = scans.begin(); itr != scans.end();){
+                    itr = scans.erase(itr);
+                }
+            }
+        }
+
+        // Save
         stored.evm_bridge_address = bridge_address;
         stored.evm_bridge_scope = (account_bridge != accounts_byaddress.end()) ? account_bridge->index : 0;
         check(stored.evm_bridge_scope > 0, "Could not find the EVM TokenBridge eosio.evm index");
@@ -90,6 +109,102 @@ namespace evm_bridge
         config_bridge.set(stored, get_self());
     };
 
+    // Set the max items & max estimated cost handled per reqnotify / refundnotify call
+    [[eosio::action]]
+    void tokenbridge::setnotify(uint64_t max_items, uint64_t max_cost){
+        // Authenticate
+        require_auth(config_bridge.get().admin);
+
+        // Validate
+        check(max_items > 0, "Max items must be above 0");
+        check(max_cost > 0, "Max cost must be above 0");
+
+        auto stored = config_settings.get_or_default();
+        stored.notify_max_items = max_items;
+        stored.notify_max_cost = max_cost;
+        // Modify
+        config_settings.set(stored, get_self());
+    };
+
+    // Set the deposits per bridgeToBatch call, queued deposits are still flushed after batching is turned off
+    [[eosio::action]]
+    void tokenbridge::setbatch(uint64_t batch_size){
+        // Authenticate
+        require_auth(config_bridge.get().admin);
+
+        // Validate
+        check(batch_size <= MAX_BRIDGE_BATCH, "Batch size is above the max batch size");
+
+        auto stored = config_settings.get_or_default();
+        stored.bridge_batch_size = batch_size;
+        // Modify
+        config_settings.set(stored, get_self());
+    };
+
+    // Set the gas limit model of an EVM call type, from the figures measured by evm/test/GasProfile.js
+    [[eosio::action]]
+    void tokenbridge::setgas(eosio::name call, uint64_t base, uint64_t per_item, uint64_t per_byte){
+        // Authenticate
+        require_auth(config_bridge.get().admin);
+
+        // Validate
+        check(base > 0, "Base gas must be above 0");
+        check(base <= MAX_CALL_GAS && per_item <= MAX_CALL_GAS && per_byte <= MAX_CALL_GAS, "Gas is above the max call gas");
+
+        auto stored = config_settings.get_or_default();
+        const gas_model model { base, per_item, per_byte };
+        if(call == "bridge"_n){
+            stored.bridge_gas = model;
+        } else if(call == "success"_n){
+            stored.success_gas = model;
+        } else if(call == "refund"_n){
+            stored.refund_gas = model;
+        } else if(call == "register"_n){
+            stored.register_gas = model;
+        } else {
+            check(false, "Call must be bridge, success, refund or register");
+        }
+        // Modify
+        config_settings.set(stored, get_self());
+    };
+
+    // Erases the legacy requests / refunds rows whose ids the dedupe rows can record instead
+    [[eosio::action]]
+    void tokenbridge::droplegacy(uint64_t max){
+        // Authenticate
+        require_auth(config_bridge.get().admin);
+
+        // Validate
+        check(max > 0, "Max rows must be above 0");
+        dedupe_window requests_dedupe(get_self(), "requests"_n, notify_shard {});
+        dedupe_window refunds_dedupe(get_self(), "refunds"_n, notify_shard {});
+
+        // Ids past the dedupe window keep their legacy row until the watermark of their partition catches up
+        stats_recorder recorder(get_self());
+        uint64_t scanned = 0;
+        requests_table requests(get_self(), get_self().value);
+        for(auto itr = requests.begin(); scanned < max && itr != requests.end(); scanned++){
+            if(!requests_dedupe.insert(static_cast<uint64_t>(checksum256ToValue(itr->call_id)))){
+                itr++;
+                continue;
+            }
+            itr = requests.erase(itr);
+            recorder.delta.rows_pruned++;
+        }
+        refunds_table refunds(get_self(), get_self().value);
+        for(auto itr = refunds.begin(); scanned < max && itr != refunds.end(); scanned++){
+            if(!refunds_dedupe.insert(static_cast<uint64_t>(checksum256ToValue(itr->call_id)))){
+                itr++;
+                continue;
+            }
+            itr = refunds.erase(itr);
+            recorder.delta.rows_pruned++;
+        }
+        requests_dedupe.save();
+        refunds_dedupe.save();
+        recorder.save();
+    };
+
     //======================== Token Bridge actions ========================
     // Trustless bridge to tEVM
     [[eosio::on_notify("*::transfer")]]
@@ -102,297 +217,681 @@ namespace evm_bridge
         uint256_t amount = uint256_t(quantity.amount);
         check(amount >= 1, "Minimum amount is not reached");
 
-        // Open config singleton
-        auto conf = config_bridge.get();
-        auto evm_conf = config.get();
+        // Find the pair in the pairs cache, before opening any eosio.evm table
+        pairs_table pairs(get_self(), get_first_receiver().value);
+        const auto pair = pairs.require_find(quantity.symbol.code().raw(), "This token has no pair registered on this bridge");
+        check(pair->active, "This token's pair is paused");
 
-        // Find the EVM account of this contract
-        account_table _accounts(EVM_SYSTEM_CONTRACT, EVM_SYSTEM_CONTRACT.value);
-        auto accounts_byaccount = _accounts.get_index<"byaccount"_n>();
-        auto evm_account = accounts_byaccount.require_find(get_self().value, "EVM account not found for token.brdg");
+        // Open config singletons
+        auto conf = config_bridge.get();
+        const auto tuning = config_settings.get_or_default();
 
         // Define EVM Account State table with EVM register contract scope
         account_state_table register_account_states(EVM_SYSTEM_CONTRACT, conf.evm_register_scope);
         auto register_account_states_bykey = register_account_states.get_index<"bykey"_n>();
+        storage_range register_range(register_account_states_bykey);
 
-        // Get array slot to find Pair pairs[] array length
-        auto pair_storage_key = toChecksum256(STORAGE_REGISTER_PAIR_INDEX);
-        auto pair_array_length = register_account_states_bykey.require_find(pair_storage_key, "No pairs have been found in the EVM register");
-        auto pair_array_slot = checksum256ToValue(keccak_256(pair_storage_key.extract_as_byte_array()));
-        auto pair_property_count = 10;
-
-        // Get each member of the Pair pairs[] array's antelope_account and compare to get the EVM address
-        std::string pair_evm_address = "";
-        vector<uint8_t> pair_evm_address_bs;
-        uint64_t pair_evm_decimals;
-        for(uint64_t i = 0; i < pair_array_length->value; i++){
-            // Get the account name string from EVM Storage, this works only for < 32bytes string which any EOSIO name should be (< 13 chars)
-            const auto account_name_checksum = register_account_states_bykey.find(getArrayMemberSlot(pair_array_slot, 6, pair_property_count, i));
-            eosio::name account_name = parseNameFromStorage(account_name_checksum->value);
-            if(account_name.value  == get_first_receiver().value){
-                const auto pair_active = register_account_states_bykey.find(getArrayMemberSlot(pair_array_slot, 0, pair_property_count, i));
-                check(pair_active->value == uint256_t(1), "This token's pair is paused");
-                const auto pair_evm_address_stored = register_account_states_bykey.find(getArrayMemberSlot(pair_array_slot, 2, pair_property_count, i));
-                pair_evm_address_bs = parseAddressFromStorage(pair_evm_address_stored->value);
-                pair_evm_decimals = static_cast<uint64_t>(register_account_states_bykey.find(getArrayMemberSlot(pair_array_slot, 3, pair_property_count, i))->value);
-            }
-        }
-        check(pair_evm_address_bs.size() > 0, "This token has no pair registered on this bridge");
-
-        // Prepare address for EVM Bridge call
-        auto evm_contract = conf.evm_bridge_address.extract_as_byte_array();
-        std::vector<uint8_t> evm_to;
-        evm_to.insert(evm_to.end(),  evm_contract.begin(), evm_contract.end());
+        // Make sure the cached pair is still at the same Pair pairs[] position and was not paused since the last sync
+        // Both members are read in slot order, the second one is the row after the first
+        const auto pair_storage = storageStruct<pair_layout>(register_range, STORAGE_REGISTER_PAIR_SLOT, pair->evm_index);
+        const bool pair_active = readMember<pair_layout::active>(pair_storage);
+        const uint256_t pair_id = readMember<pair_layout::id>(pair_storage);
+        check(pair_id == uint256_t(pair->evm_pair_id), "This token's pair has changed, please call syncpairs");
+        check(pair_active, "This token's pair is paused");
 
-        // Prepare EVM function signature & arguments
-        std::vector<uint8_t> data;
-        auto fnsig = checksum256ToValue(eosio::checksum256(toBin(EVM_BRIDGE_SIGNATURE)));
-        vector<uint8_t> fnsig_bs = intx::to_byte_string(fnsig);
-        fnsig_bs.resize(16);
-        data.insert(data.end(), fnsig_bs.begin(), fnsig_bs.end());
-        data.insert(data.end(), pair_evm_address_bs.begin(), pair_evm_address_bs.end());
+        uint64_t pair_evm_decimals = pair->evm_decimals;
 
         // Receiver EVM address from memo
         memo.replace(0, 2, ""); // remove the Ox
-        auto receiver_ba = pad160(eosio::checksum160( toBin(memo))).extract_as_byte_array();
-        std::vector<uint8_t> receiver(receiver_ba.begin(), receiver_ba.end());
-        receiver = pad(receiver, 32, true);
-        data.insert(data.end(),  receiver.begin(), receiver.end());
+        const eosio::checksum160 receiver = toChecksum160(memo);
+
+        const uint256_t evm_amount = toEvmAmount(static_cast<uint64_t>(quantity.amount), quantity.symbol.precision(), pair_evm_decimals);
+
+        // Counted in the token's tokenstats row only, the transfer's single metrics write
+        stats_recorder recorder(get_self());
+        recorder.delta.slots_read = 2;
+        recorder.add_token(get_first_receiver(), quantity, &tokenstats::bridged, &tokenstats::bridged_amount);
+
+        // Batching: queue the deposit, the one filling a batch sends it
+        if(tuning.bridge_batch_size > 0){
+            deposits_table deposits(get_self(), get_self().value);
+            const uint64_t id = deposits.available_primary_key();
+            deposits.emplace(get_self(), [&](auto& d) {
+                d.id = id;
+                d.evm_token = pair->evm_address;
+                d.receiver = receiver;
+                d.amount = toChecksum256(evm_amount);
+                d.sender = from;
+                d.token_contract = get_first_receiver();
+                d.quantity = quantity;
+            });
+            if(id + 1 - deposits.begin()->id >= tuning.bridge_batch_size){
+                flushDeposits(conf, tuning, tuning.bridge_batch_size, recorder);
+            }
+            recorder.saveToToken();
+            return;
+        }
 
-        // Amount
-        vector<uint8_t> amount_bs = pad(intx::to_byte_string(amount * pow (10, pair_evm_decimals)), 32, true);
-        data.insert(data.end(),  amount_bs.begin(), amount_bs.end());
+        // Find the EVM account of this contract & its next nonce, past the calls of deposits notified earlier in the transaction
+        auto evm_conf = config.get();
+        nonce_allocator nonces(get_self());
 
-        // Sender
-        std::string sender = from.to_string();
-        insertElementPositions(&data, 128); // Our string position
-        insertString(&data, sender, sender.length());
+        // Prepare EVM function call: bridgeTo(token, receiver, amount, sender)
+        const std::string sender = from.to_string();
+        const std::vector<uint8_t> data = EVM_BRIDGE_CALL.encode(pair->evm_address, receiver, evm_amount, sender);
 
         // call TokenBridge.bridgeTo(address token, address receiver, uint amount) on EVM using eosio.evm
         action(
             permission_level {get_self(), "active"_n},
             EVM_SYSTEM_CONTRACT,
             "raw"_n,
-            std::make_tuple(get_self(), rlp::encode(evm_account->nonce, evm_conf.gas_price, BRIDGE_GAS, evm_to, uint256_t(0), data, CURRENT_CHAIN_ID, 0, 0),  false, std::optional<eosio::checksum160>(evm_account->address))
+            std::make_tuple(get_self(), encodeTransaction(nonces.reserve(), evm_conf.gas_price, tuning.bridge_gas.limit(1, sender.size()), conf.evm_bridge_address, uint256_t(0), data, CURRENT_CHAIN_ID),  false, std::optional<eosio::checksum160>(nonces.address))
         ).send();
+        nonces.save();
+
+        // Record metrics
+        recorder.delta.inline_actions = 1;
+        recorder.saveToToken();
     };
 
-    // Refunds bridge request to EVM if minting reverted on EVM
+    // Sends queued deposits to EVM, for when a batch is left unfilled
     [[eosio::action]]
-    void tokenbridge::refundnotify()
+    void tokenbridge::flush(uint64_t max)
     {
-        // Open config singletons
-        auto conf = config_bridge.get();
-        auto evm_conf = config.get();
+        check(max > 0, "Max deposits to flush must be above 0");
 
-        // Find the EVM account of this contract
-        account_table _accounts(EVM_SYSTEM_CONTRACT, EVM_SYSTEM_CONTRACT.value);
-        auto accounts_byaccount = _accounts.get_index<"byaccount"_n>();
-        auto account = accounts_byaccount.require_find(get_self().value, "Account not found");
+        stats_recorder recorder(get_self());
+        const uint64_t flushed = flushDeposits(config_bridge.get(), config_settings.get_or_default(), std::min(max, MAX_BRIDGE_BATCH), recorder);
+        check(flushed > 0, "No deposits to flush");
+        recorder.save();
+    };
 
-        // Clean out old processed refunds
-        refunds_table refunds(get_self(), get_self().value);
-        auto refunds_by_timestamp = refunds.get_index<"timestamp"_n>();
-        auto upper = refunds_by_timestamp.upper_bound(current_time_point().sec_since_epoch() - 60); // remove 60s so we get only requests that are at least 1mn old
-        uint64_t count = 10; // max 10 refunds so we never overload CPU
-        for(auto itr = refunds_by_timestamp.begin(); count > 0 && itr != upper; count--) {
-            itr = refunds_by_timestamp.erase(itr);
+    // Erases up to `max` queued deposits & sends them in one bridgeToBatch call, EVM refunds the ones it cannot mint
+    // Deposits whose pair was removed, moved or paused while they were queued are sent back to their sender here instead,
+    // saving them the EVM refund round trip
+    uint64_t tokenbridge::flushDeposits(const bridgeconfig& conf, const settings& tuning, uint64_t max, stats_recorder& recorder)
+    {
+        account_state_table register_account_states(EVM_SYSTEM_CONTRACT, conf.evm_register_scope);
+        auto register_account_states_bykey = register_account_states.get_index<"bykey"_n>();
+
+        // Whether a token's pair is still registered & active on EVM, checked once per token of the batch
+        struct pair_check {
+            eosio::name token_contract;
+            eosio::symbol_code code;
+            bool open;
+        };
+        std::vector<pair_check> checked;
+        const auto pairOpen = [&](eosio::name token_contract, eosio::symbol_code code) {
+            for(const auto& entry : checked){
+                if(entry.token_contract == token_contract && entry.code == code) return entry.open;
+            }
+            pairs_table pairs(get_self(), token_contract.value);
+            const auto pair = pairs.find(code.raw());
+            bool open = pair != pairs.end() && pair->active;
+            if(open){
+                storage_range register_range(register_account_states_bykey);
+                const auto pair_storage = storageStruct<pair_layout>(register_range, STORAGE_REGISTER_PAIR_SLOT, pair->evm_index);
+                open = readMember<pair_layout::active>(pair_storage) && readMember<pair_layout::id>(pair_storage) == uint256_t(pair->evm_pair_id);
+                recorder.delta.slots_read += 2;
+            }
+            checked.push_back(pair_check { token_contract, code, open });
+            return open;
+        };
+
+        std::vector<abi::address> tokens;
+        std::vector<abi::address> receivers;
+        std::vector<uint256_t> amounts;
+        std::vector<std::string> senders;
+        std::vector<std::string> antelope_tokens;
+        std::vector<std::string> antelope_symbols;
+        uint64_t string_bytes = 0;
+        uint64_t returned = 0;
+        deposits_table deposits(get_self(), get_self().value);
+        for(auto itr = deposits.begin(); itr != deposits.end() && tokens.size() + returned < max;){
+            if(!pairOpen(itr->token_contract, itr->quantity.symbol.code())){
+                action(
+                    permission_level{ get_self(), "active"_n },
+                        itr->token_contract,
+                        "transfer"_n,
+                        std::make_tuple(get_self(), itr->sender, itr->quantity, std::string("Bridge refund, the token's pair is no longer open"))
+                ).send();
+                recorder.delta.inline_actions += 1;
+                recorder.delta.deposits_returned += 1;
+                returned++;
+                itr = deposits.erase(itr);
+                continue;
+            }
+            tokens.push_back(itr->evm_token);
+            receivers.push_back(itr->receiver);
+            amounts.push_back(checksum256ToValue(itr->amount));
+            senders.push_back(itr->sender.to_string());
+            antelope_tokens.push_back(itr->token_contract.to_string());
+            antelope_symbols.push_back(itr->quantity.symbol.code().to_string());
+            string_bytes += senders.back().size() + antelope_tokens.back().size() + antelope_symbols.back().size();
+            itr = deposits.erase(itr);
+        }
+        if(tokens.empty()){
+            return returned;
         }
 
-        // Define EVM Account State table with EVM bridge contract scope
-        account_state_table bridge_account_states(EVM_SYSTEM_CONTRACT, conf.evm_bridge_scope);
-        auto bridge_account_states_bykey = bridge_account_states.get_index<"bykey"_n>();
+        // Find the EVM account of this contract & its next nonce
+        auto evm_conf = config.get();
+        nonce_allocator nonces(get_self());
+
+        // call TokenBridge.bridgeToBatch(address[] tokens, address[] receivers, uint[] amounts, string[] senders, string[] antelope_tokens, string[] antelope_symbols) on EVM using eosio.evm
+        // Each deposit carries its Antelope token, for EVM to refund it even if its pair leaves the register before the batch runs
+        const std::vector<abi::string> sender_names(senders.begin(), senders.end());
+        const std::vector<abi::string> token_names(antelope_tokens.begin(), antelope_tokens.end());
+        const std::vector<abi::string> symbol_names(antelope_symbols.begin(), antelope_symbols.end());
+        const std::vector<uint8_t> data = EVM_BRIDGE_BATCH_CALL.encode(tokens, receivers, amounts, sender_names, token_names, symbol_names);
+        const uint64_t gas = tuning.bridge_gas.limit(tokens.size(), string_bytes);
+        action(
+            permission_level {get_self(), "active"_n},
+            EVM_SYSTEM_CONTRACT,
+            "raw"_n,
+            std::make_tuple(get_self(), encodeTransaction(nonces.reserve(), evm_conf.gas_price, gas, conf.evm_bridge_address, uint256_t(0), data, CURRENT_CHAIN_ID),  false, std::optional<eosio::checksum160>(nonces.address))
+        ).send();
+        nonces.save();
+
+        recorder.delta.inline_actions += 1;
+        recorder.delta.batches_sent += 1;
+        return tokens.size() + returned;
+    };
+
+    // Syncs the pairs cache from the EVM register, a few pairs at a time, and erases the cached pairs it no longer has
+    [[eosio::action]]
+    void tokenbridge::syncpairs(uint64_t max)
+    {
+        check(max > 0, "Max pairs to sync must be above 0");
+
+        // Open config singleton
+        auto conf = config_bridge.get();
 
         // Define EVM Account State table with EVM register contract scope
         account_state_table register_account_states(EVM_SYSTEM_CONTRACT, conf.evm_register_scope);
         auto register_account_states_bykey = register_account_states.get_index<"bykey"_n>();
+        storage_range register_range(register_account_states_bykey);
+
+        // Get array slot to find Pair pairs[] array length, an empty register still has its removed pairs to erase
+        const uint64_t pair_count = static_cast<uint64_t>(readWordFromStorage(register_account_states_bykey, toChecksum256(STORAGE_REGISTER_PAIR_INDEX)));
+
+        // Resume from where the last call stopped
+        pairsync_singleton pairsync(get_self(), get_self().value);
+        auto cursor = pairsync.get_or_default();
+        if(cursor.next_index >= pair_count){
+            cursor.next_index = 0;
+        }
+        const uint64_t last_index = (pair_count - cursor.next_index > max) ? cursor.next_index + max : pair_count;
+
+        pairkeys_table keys(get_self(), get_self().value);
+        for(uint64_t i = cursor.next_index; i < last_index; i++){
+            const evm_pair pair = readPair(storageStruct<pair_layout>(register_range, STORAGE_REGISTER_PAIR_SLOT, i));
+
+            // Upsert the pair in the cache
+            pairs_table pairs(get_self(), pair.account.value);
+            const auto upsert = [&](auto& p) {
+                p.antelope_symbol = pair.symbol;
+                p.evm_pair_id = pair.id;
+                p.evm_index = i;
+                p.evm_address = pair.evm_address;
+                p.evm_decimals = pair.evm_decimals;
+                p.active = pair.active;
+                p.evm_symbol = pair.evm_symbol;
+                p.evm_name = pair.evm_name;
+            };
+            const auto cached = pairs.find(pair.symbol.raw());
+            if(cached == pairs.end()){
+                pairs.emplace(get_self(), upsert);
+            } else {
+                pairs.modify(cached, get_self(), upsert);
+            }
+            if(keys.find(pair.id) == keys.end()){
+                keys.emplace(get_self(), [&](auto& k) {
+                    k.evm_pair_id = pair.id;
+                    k.token_contract = pair.account;
+                    k.antelope_symbol = pair.symbol;
+                });
+            }
+        }
 
-        // Get array slot to find Refund refunds[] array length
-        auto refund_storage_key = toChecksum256(STORAGE_BRIDGE_REFUND_INDEX);
-        auto refund_array_length = bridge_account_states_bykey.require_find(refund_storage_key, "No refunds found");
-        auto refund_array_slot = checksum256ToValue(keccak_256(refund_storage_key.extract_as_byte_array()));
-        uint8_t refund_property_count = 6;
+        // Check up to `max` cached pairs against the register's pair_index_by_id, erasing the ones it removed
+        // A row re-registered under the same symbol since then has another pair id & stays
+        auto key = keys.lower_bound(cursor.next_key);
+        for(uint64_t checked = 0; checked < max && key != keys.end(); checked++){
+            if(readWordFromStorage(register_account_states_bykey, toChecksum256(getMappingSlot(uint256_t(key->evm_pair_id), STORAGE_REGISTER_PAIR_BY_ID_INDEX))) != 0){
+                key++;
+                continue;
+            }
+            pairs_table pairs(get_self(), key->token_contract.value);
+            const auto cached = pairs.find(key->antelope_symbol.raw());
+            if(cached != pairs.end() && cached->evm_pair_id == key->evm_pair_id){
+                pairs.erase(cached);
+            }
+            key = keys.erase(key);
+        }
+
+        // Save the cursors, starting over once all pairs have been synced & checked
+        cursor.next_index = (last_index >= pair_count) ? 0 : last_index;
+        cursor.next_key = (key == keys.end()) ? 0 : key->evm_pair_id;
+        pairsync.set(cursor, get_self());
+    };
 
-        // Prepare address for callback
-        auto evm_contract = conf.evm_bridge_address.extract_as_byte_array();
-        std::vector<uint8_t> to;
-        to.insert(to.end(), evm_contract.begin(), evm_contract.end());
+    // Refunds bridge request to EVM if minting reverted on EVM
+    [[eosio::action]]
+    notify_result tokenbridge::refundnotify(uint64_t shard_id, uint64_t shard_count)
+    {
+        notify_context ctx(get_self(), config_bridge.get(), config.get(), notify_shard::of(shard_id, shard_count));
+        const notify_result result = processRefunds(ctx, ctx.arrayLength(STORAGE_BRIDGE_REFUND_INDEX, "No refunds found"));
+        ctx.save();
+        return result;
+    }
+
+    // Trustless bridge from tEVM
+    [[eosio::action]]
+    notify_result tokenbridge::reqnotify(uint64_t shard_id, uint64_t shard_count)
+    {
+        notify_context ctx(get_self(), config_bridge.get(), config.get(), notify_shard::of(shard_id, shard_count));
+        const notify_result result = processRequests(ctx, ctx.arrayLength(STORAGE_BRIDGE_REQUEST_INDEX, "No requests found"), nullptr);
+        ctx.save();
+        return result;
+    };
+
+    // Both notify actions in one transaction: requests first, then refunds with what is left of the budget
+    [[eosio::action]]
+    notify_result tokenbridge::process(uint64_t shard_id, uint64_t shard_count)
+    {
+        notify_context ctx(get_self(), config_bridge.get(), config.get(), notify_shard::of(shard_id, shard_count));
+        const uint64_t request_count = ctx.arrayLength(STORAGE_BRIDGE_REQUEST_INDEX);
+        const uint64_t refund_count = ctx.arrayLength(STORAGE_BRIDGE_REFUND_INDEX);
+        check(request_count > 0 || refund_count > 0, "No requests or refunds found");
+
+        const notify_result requests = processRequests(ctx, request_count, nullptr);
+        const notify_result refunds = processRefunds(ctx, refund_count);
+        ctx.save();
+        return notify_result { requests.processed + refunds.processed, requests.pending + refunds.pending };
+    };
+
+    // Pays out the TokenBridge refunds[] items the budget left in `ctx` allows
+    notify_result tokenbridge::processRefunds(notify_context& ctx, uint64_t refund_count)
+    {
+        if(refund_count == 0){
+            return notify_result { 0, 0 };
+        }
+        dedupe_window& processed_refunds = ctx.refunds_dedupe;
+        auto bridge_account_states_bykey = ctx.bridge_states.get_index<"bykey"_n>();
+        storage_range bridge_range(bridge_account_states_bykey);
 
-        const auto fnsig = toBin(EVM_REFUND_CALLBACK_SIGNATURE);
         const std::string memo = "Bridge refund";
 
-        // Todo: optimize max (i<2)
-        for(uint64_t i = 0; i < refund_array_length->value && i < 2; i++){
-            const auto refund_id_checksum = bridge_account_states_bykey.find(getArrayMemberSlot(refund_array_slot, 0, refund_property_count, i));
-            const uint256_t refund_id = (refund_id_checksum != bridge_account_states_bykey.end()) ? refund_id_checksum->value : uint256_t(0); // Needed because row is not set at all if the value is 0
-            const auto refund_id_bs = pad(intx::to_byte_string(refund_id), 16, true);
-            const eosio::name receiver = parseNameFromStorage(bridge_account_states_bykey.find(getArrayMemberSlot(refund_array_slot, 4, refund_property_count, i))->value);
-            const eosio::name token_account_name = parseNameFromStorage(bridge_account_states_bykey.find(getArrayMemberSlot(refund_array_slot, 2, refund_property_count, i))->value);
-            const eosio::symbol_code antelope_symbol = parseSymbolCodeFromStorage(bridge_account_states_bykey.find(getArrayMemberSlot(refund_array_slot, 3, refund_property_count, i))->value);
-            const uint64_t evm_decimals = static_cast<uint64_t>(bridge_account_states_bykey.find(getArrayMemberSlot(refund_array_slot, 5, refund_property_count, i))->value);
-
-            // Get token from token stat table (and not EVM Register, in case the token issuer changes precision)
-            eosio_tokens token_row(token_account_name, antelope_symbol.raw());
-            const auto antelope_token = token_row.require_find(antelope_symbol.raw(), "Token not found. Make sure the symbol is correct.");
-
-            // Get amount according to decimal places on each chain
-            uint256_t amount = bridge_account_states_bykey.find(getArrayMemberSlot(refund_array_slot, 1, refund_property_count, i))->value;
-            if(evm_decimals < antelope_token->supply.symbol.precision()){
-                const double exponent = (evm_decimals - antelope_token->supply.symbol.precision()) * 1.0;
-                amount = amount / pow(10.0, exponent);
-            } else {
-                const double exponent = (antelope_token->supply.symbol.precision() - evm_decimals) * 1.0;
-                amount = amount * pow(10.0, exponent);
+        // Stop once the max items or the estimated cost budget are reached
+        notify_budget& budget = ctx.budget;
+        const uint64_t processed_before = budget.processed;
+        const uint64_t skipped_before = budget.skipped;
+        // A transfer per refund, plus the one refundsSuccessful call they all share
+        const uint64_t refund_cost = 8 * SLOT_READ_COST + INLINE_ACTION_COST;
+        std::vector<uint256_t> refund_ids;
+
+        // Resume the shard's pass down the array, or start a new one from its last item
+        notifyscan& scan = processed_refunds.scan();
+        if(scan.cursor == 0){
+            scan.cursor = refund_count;
+            scan.pass_end = ctx.nextId(STORAGE_BRIDGE_REFUND_ID_INDEX);
+            scan.floor = scan.pass_end;
+        }
+        uint64_t cursor = std::min(scan.cursor, refund_count);
+        for(; cursor > 0 && budget.can_process(refund_cost + (refund_ids.empty() ? INLINE_ACTION_COST : 0)); cursor--){
+            const uint64_t i = cursor - 1;
+            const auto refund_storage = storageStruct<refund_layout>(bridge_range, STORAGE_BRIDGE_REFUND_SLOT, i);
+            const uint64_t refund_id = static_cast<uint64_t>(readMember<refund_layout::id>(refund_storage));
+            budget.spend_slot_reads(1);
+
+            // Left to the cranks of the shard it belongs to
+            if(!ctx.shard.owns(refund_id)){
+                budget.skipped++;
+                continue;
             }
-            const uint64_t amount_64 = static_cast<uint64_t>(amount);
-            const eosio::asset quantity = asset(amount_64, antelope_token->supply.symbol);
 
-            // Check refund not already being processed
-            auto refunds_by_call_id = refunds.get_index<"callid"_n>();
-            auto exists = refunds_by_call_id.find(toChecksum256(refund_id));
-            if(exists != refunds_by_call_id.end()){
+            // Skip refunds under the watermark without reading the rest of them
+            if(processed_refunds.below(refund_id)){
+                budget.skipped++;
+                ctx.recorder.delta.watermark_skipped++;
                 continue;
             }
 
-            // Add refund
-            refunds.emplace(get_self(), [&](auto& r) {
-                r.refund_id = refunds.available_primary_key();
-                r.call_id = toChecksum256(refund_id);
-                r.timestamp = current_time_point();
-            });
+            // Check refund not already being processed
+            if(processed_refunds.contains(refund_id)){
+                budget.skipped++;
+                ctx.recorder.delta.duplicates_skipped++;
+                continue;
+            }
 
-            // Send tokens to receiver
-            action(
-                permission_level{ get_self(), "active"_n },
-                    token_account_name,
-                    "transfer"_n,
-                    std::make_tuple(get_self(), receiver, quantity, memo)
-            ).send();
+            // Past the dedupe window: left for once the pass has moved the watermark up to it
+            if(!processed_refunds.fits(refund_id)){
+                scan.floor = std::min(scan.floor, refund_id);
+                continue;
+            }
 
-            std::vector<uint8_t> data;
-            data.insert(data.end(), fnsig.begin(), fnsig.end());
-            data.insert(data.end(), refund_id_bs.begin(), refund_id_bs.end());
+            const pending_refund refund = readRefund(refund_storage, refund_id, ctx.symbols);
+            budget.spend_slot_reads(7);
+
+            // Mark refund as processed
+            processed_refunds.insert(refund_id);
+
+            if(refund.resolved){
+                // Send tokens to receiver
+                ctx.recorder.add_token(refund.token_contract, refund.quantity, &tokenstats::refunds_processed, &tokenstats::refunds_amount);
+                action(
+                    permission_level{ get_self(), "active"_n },
+                        refund.token_contract,
+                        "transfer"_n,
+                        std::make_tuple(get_self(), refund.receiver, refund.quantity, memo)
+                ).send();
+                budget.spend_inline_actions(1);
+            } else {
+                // No such token to pay it in: settle it on EVM all the same, so it does not hold up the queue forever
+                eosio::print("Refund ", refund_id, " has no Antelope token to pay it in, settled without a transfer\n");
+                ctx.recorder.delta.refunds_unresolved++;
+            }
+            if(refund_ids.empty()){
+                budget.spend_inline_actions(1); // the refundsSuccessful call
+            }
+            refund_ids.push_back(uint256_t(refund_id));
+            budget.processed++;
+        }
 
-            // Send refundSuccessful call to EVM using eosio.evm
+        // Send a single refundsSuccessful call to EVM using eosio.evm for every refund paid out
+        if(!refund_ids.empty()){
+            const std::vector<uint8_t> data = EVM_REFUND_CALLBACKS_CALL.encode(refund_ids);
             action(
                 permission_level {get_self(), "active"_n},
                 EVM_SYSTEM_CONTRACT,
                 "raw"_n,
-                std::make_tuple(get_self(), rlp::encode(account->nonce, evm_conf.gas_price, REFUND_CB_GAS, to, uint256_t(0), data, 41, 0, 0),  false, std::optional<eosio::checksum160>(account->address))
+                std::make_tuple(get_self(), ctx.encodeCall(ctx.tuning.refund_gas.limit(refund_ids.size(), 0), data),  false, std::optional<eosio::checksum160>(ctx.address))
             ).send();
         }
 
+        // The pass reached the first refund: move the watermarks up to the first refund left unprocessed, then past the ones now in flight
+        scan.cursor = cursor;
+        if(cursor == 0){
+            processed_refunds.moveTo(scan.floor);
+        }
+        processed_refunds.advance();
+
+        const uint64_t processed = budget.processed - processed_before;
+        ctx.recorder.delta.refunds_processed += processed;
+        return notify_result { processed, refund_count - processed - (budget.skipped - skipped_before) };
     }
 
-    // Trustless bridge from tEVM
-    [[eosio::action]]
-    void tokenbridge::reqnotify()
+    // Pays out the TokenBridge requests[] items the budget left in `ctx` allows, or when `preview` is set only lists them
+    notify_result tokenbridge::processRequests(notify_context& ctx, uint64_t request_count, std::vector<pending_request>* preview)
     {
-        // Open config singletons
-        auto conf = config_bridge.get();
-        auto evm_conf = config.get();
-
-        // Find the EVM account of this contract
-        account_table _accounts(EVM_SYSTEM_CONTRACT, EVM_SYSTEM_CONTRACT.value);
-        auto accounts_byaccount = _accounts.get_index<"byaccount"_n>();
-        auto evm_account = accounts_byaccount.require_find(get_self().value, "EVM account not found for token.brdg");
-
-        // Erase old requests
-        requests_table requests(get_self(), get_self().value);
-        auto requests_by_timestamp = requests.get_index<"timestamp"_n>();
-        auto upper = requests_by_timestamp.upper_bound(current_time_point().sec_since_epoch() - 60); // remove 60s so we get only requests that are at least 1mn old
-        uint64_t count = 10; // max 10 requests to remove so we never overload CPU
-        for(auto itr = requests_by_timestamp.begin(); count > 0 && itr != upper; count--) {
-            itr = requests_by_timestamp.erase(itr);
+        if(request_count == 0){
+            return notify_result { 0, 0 };
+        }
+        dedupe_window& processed_requests = ctx.requests_dedupe;
+        auto bridge_account_states_bykey = ctx.bridge_states.get_index<"bykey"_n>();
+        storage_range bridge_range(bridge_account_states_bykey);
+
+        // Stop once the max items or the estimated cost budget are reached
+        notify_budget& budget = ctx.budget;
+        const uint64_t processed_before = budget.processed;
+        const uint64_t skipped_before = budget.skipped;
+        // A transfer per request, plus the one requestsSuccessful call they all share
+        const uint64_t request_cost = 9 * SLOT_READ_COST + INLINE_ACTION_COST;
+        std::vector<uint256_t> call_ids;
+
+        // Resume the shard's pass down the array, or start a new one from its last item
+        notifyscan& scan = processed_requests.scan();
+        if(scan.cursor == 0){
+            scan.cursor = request_count;
+            scan.pass_end = ctx.nextId(STORAGE_BRIDGE_REQUEST_ID_INDEX);
+            scan.floor = scan.pass_end;
         }
+        uint64_t cursor = std::min(scan.cursor, request_count);
+        for(; cursor > 0 && budget.can_process(request_cost + (call_ids.empty() ? INLINE_ACTION_COST : 0)); cursor--){
+            const uint64_t i = cursor - 1;
+            const auto request_storage = storageStruct<request_layout>(bridge_range, STORAGE_BRIDGE_REQUEST_SLOT, i);
+            const uint64_t call_id = static_cast<uint64_t>(readMember<request_layout::id>(request_storage));
+            budget.spend_slot_reads(1);
+
+            // Left to the cranks of the shard it belongs to
+            if(!ctx.shard.owns(call_id)){
+                budget.skipped++;
+                continue;
+            }
 
-        // Define EVM Account State table with EVM bridge contract scope
-        account_state_table bridge_account_states(EVM_SYSTEM_CONTRACT, conf.evm_bridge_scope);
-        auto bridge_account_states_bykey = bridge_account_states.get_index<"bykey"_n>();
+            // Skip requests under the watermark without reading the rest of them
+            if(processed_requests.below(call_id)){
+                budget.skipped++;
+                ctx.recorder.delta.watermark_skipped++;
+                continue;
+            }
 
-        // Define EVM Account State table with EVM register contract scope
-        account_state_table register_account_states(EVM_SYSTEM_CONTRACT, conf.evm_register_scope);
-        auto register_account_states_bykey = register_account_states.get_index<"bykey"_n>();
+            // Check request not already being processed
+            if(processed_requests.contains(call_id)){
+                budget.skipped++;
+                ctx.recorder.delta.duplicates_skipped++;
+                continue;
+            }
 
-        // Get array slot to find the TokenBridge Request[] requests array length
-        auto request_storage_key = toChecksum256(STORAGE_BRIDGE_REQUEST_INDEX);
-        auto request_array_length = bridge_account_states_bykey.require_find(request_storage_key, "No requests found");
-        auto request_array_slot = checksum256ToValue(keccak_256(request_storage_key.extract_as_byte_array()));
-        uint8_t request_property_count = 8;
-
-        // Prepare address & function signature for callback
-        auto evm_contract = conf.evm_bridge_address.extract_as_byte_array();
-        std::vector<uint8_t> evm_to;
-        evm_to.insert(evm_to.end(), evm_contract.begin(), evm_contract.end());
-        auto fnsig = toBin(EVM_SUCCESS_CALLBACK_SIGNATURE);
-
-        // Loop over the requests
-        // Todo: optimize max (i<2)
-        for(uint64_t i = 0; i < request_array_length->value && i < 2; i++){
-            const auto call_id_checksum = bridge_account_states_bykey.find(getArrayMemberSlot(request_array_slot, 0, request_property_count, i));
-            const uint256_t call_id = (call_id_checksum != bridge_account_states_bykey.end()) ? call_id_checksum->value : uint256_t(0); // Needed because row is not set at all if the value is 0
-            const vector<uint8_t> call_id_bs = pad(intx::to_byte_string(call_id), 16, true);
-            const eosio::name token_account_name = parseNameFromStorage(bridge_account_states_bykey.find(getArrayMemberSlot(request_array_slot, 4, request_property_count, i))->value);
-            const uint64_t evm_decimals = static_cast<uint64_t>(bridge_account_states_bykey.find(getArrayMemberSlot(request_array_slot, 7, request_property_count, i))->value);
-            const eosio::name receiver = parseNameFromStorage(bridge_account_states_bykey.find(getArrayMemberSlot(request_array_slot, 6, request_property_count, i))->value);
-            const eosio::symbol_code antelope_symbol = parseSymbolCodeFromStorage(bridge_account_states_bykey.find(getArrayMemberSlot(request_array_slot, 5, request_property_count, i))->value);
-            const auto sender_address_checksum = bridge_account_states_bykey.find(getArrayMemberSlot(request_array_slot, 1, request_property_count, i));
-            std::string sender_address = bin2hex(parseAddressFromStorage(sender_address_checksum->value));
-            const std::string memo = "Sent from tEVM by 0x" + sender_address;
-
-            // Get token from token stat table (and not EVM Register, in case the token issuer changes precision)
-            eosio_tokens token_row(token_account_name, antelope_symbol.raw());
-            auto antelope_token = token_row.require_find(antelope_symbol.raw(), "Token not found. Make sure the symbol is correct.");
-
-            // We made sure on the tEVM side that the max precision for bridging matches antelope and that the wei amount to bridge (minus precision) is =< uint64_t max of 18446744073709551615
-            uint256_t amount = bridge_account_states_bykey.find(getArrayMemberSlot(request_array_slot, 2, request_property_count, i))->value;
-            if(evm_decimals < antelope_token->supply.symbol.precision()){
-                const double exponent = (evm_decimals - antelope_token->supply.symbol.precision()) * 1.0;
-                amount = amount / pow(10.0, exponent);
-            } else {
-                const double exponent = (antelope_token->supply.symbol.precision() - evm_decimals) * 1.0;
-                amount = amount * pow(10.0, exponent);
+            // Past the dedupe window: left for once the pass has moved the watermark up to it
+            if(!processed_requests.fits(call_id)){
+                scan.floor = std::min(scan.floor, call_id);
+                continue;
             }
-            uint64_t amount_64 = static_cast<uint64_t>(amount);
-            const eosio::asset quantity = asset(amount_64, antelope_token->supply.symbol);
 
-            // Check request not already being processed
-            auto requests_by_call_id = requests.get_index<"callid"_n>();
-            auto exists = requests_by_call_id.find(toChecksum256(call_id));
-            if(exists != requests_by_call_id.end()){
+            const pending_request request = readRequest(request_storage, call_id, ctx.symbols);
+            budget.spend_slot_reads(8);
+            budget.spend_inline_actions(call_ids.empty() ? 2 : 1);
+            call_ids.push_back(uint256_t(call_id));
+            budget.processed++;
+
+            if(preview){
+                preview->push_back(request);
                 continue;
             }
+            ctx.recorder.add_token(request.token_contract, request.quantity, &tokenstats::requests_processed, &tokenstats::requests_amount);
 
-            // Add request
-            requests.emplace(get_self(), [&](auto& r) {
-                r.request_id = requests.available_primary_key();
-                r.call_id = toChecksum256(call_id);
-                r.timestamp = current_time_point();
-            });
+            // Mark request as processed
+            processed_requests.insert(call_id);
 
             // Send tokens to receiver
+            const std::string memo = "Sent from tEVM by 0x" + bin2hex(request.sender.extract_as_byte_array());
             action(
                 permission_level{ get_self(), "active"_n },
-                    token_account_name,
+                    request.token_contract,
                     "transfer"_n,
-                    std::make_tuple(get_self(), receiver, quantity, memo)
+                    std::make_tuple(get_self(), request.receiver, request.quantity, memo)
             ).send();
+        }
 
-            // Setup success callback call so request get deleted on tEVM
-            std::vector<uint8_t> data;
-            data.insert(data.end(), fnsig.begin(), fnsig.end());
-            data.insert(data.end(), call_id_bs.begin(), call_id_bs.end());
+        const uint64_t processed = budget.processed - processed_before;
+        const notify_result result { processed, request_count - processed - (budget.skipped - skipped_before) };
+        if(preview){
+            return result;
+        }
 
-            // Call success callback on tEVM using eosio.evm
+        // Call the success callback once on tEVM using eosio.evm so every request paid out gets deleted there
+        if(!call_ids.empty()){
+            const std::vector<uint8_t> data = EVM_SUCCESS_CALLBACKS_CALL.encode(call_ids);
             action(
                permission_level {get_self(), "active"_n},
                EVM_SYSTEM_CONTRACT,
                "raw"_n,
-               std::make_tuple(get_self(), rlp::encode(evm_account->nonce + i, evm_conf.gas_price, SUCCESS_CB_GAS, evm_to, uint256_t(0), data, CURRENT_CHAIN_ID, 0, 0),  false, std::optional<eosio::checksum160>(evm_account->address))
+               std::make_tuple(get_self(), ctx.encodeCall(ctx.tuning.success_gas.limit(call_ids.size(), 0), data),  false, std::optional<eosio::checksum160>(ctx.address))
             ).send();
         }
+
+        // The pass reached the first request: move the watermarks up to the first request left unprocessed, then past the ones now in flight
+        scan.cursor = cursor;
+        if(cursor == 0){
+            processed_requests.moveTo(scan.floor);
+        }
+        processed_requests.advance();
+        ctx.recorder.delta.requests_processed += processed;
+        return result;
+    };
+
+    //======================== Read only queries ========================
+    // Lists the TokenBridge requests not paid out yet
+    [[eosio::action, eosio::read_only]]
+    pending_requests tokenbridge::pending(uint64_t offset, uint64_t limit)
+    {
+        check(limit > 0 && limit <= MAX_QUERY_ITEMS, "Limit must be between 1 and " + std::to_string(MAX_QUERY_ITEMS));
+        auto conf = config_bridge.get();
+
+        account_state_table bridge_account_states(EVM_SYSTEM_CONTRACT, conf.evm_bridge_scope);
+        auto bridge_account_states_bykey = bridge_account_states.get_index<"bykey"_n>();
+        storage_range bridge_range(bridge_account_states_bykey);
+
+        dedupe_window processed_requests(get_self(), "requests"_n, notify_shard {});
+
+        token_symbols symbols;
+        pending_requests page;
+        page.total = static_cast<uint64_t>(readWordFromStorage(bridge_account_states_bykey, toChecksum256(STORAGE_BRIDGE_REQUEST_INDEX)));
+        page.next = std::min(page.total, std::max(offset, offset + limit)); // offset + limit saturates
+        for(uint64_t i = offset; i < page.next; i++){
+            const auto request_storage = storageStruct<request_layout>(bridge_range, STORAGE_BRIDGE_REQUEST_SLOT, i);
+            const uint64_t call_id = static_cast<uint64_t>(readMember<request_layout::id>(request_storage));
+            if(processed_requests.contains(call_id)){
+                continue;
+            }
+            page.items.push_back(readRequest(request_storage, call_id, symbols));
+        }
+        return page;
     };
 
+    // Lists the TokenBridge refunds not paid back yet
+    [[eosio::action, eosio::read_only]]
+    pending_refunds tokenbridge::pendrefunds(uint64_t offset, uint64_t limit)
+    {
+        check(limit > 0 && limit <= MAX_QUERY_ITEMS, "Limit must be between 1 and " + std::to_string(MAX_QUERY_ITEMS));
+        auto conf = config_bridge.get();
+
+        account_state_table bridge_account_states(EVM_SYSTEM_CONTRACT, conf.evm_bridge_scope);
+        auto bridge_account_states_bykey = bridge_account_states.get_index<"bykey"_n>();
+        storage_range bridge_range(bridge_account_states_bykey);
+
+        dedupe_window processed_refunds(get_self(), "refunds"_n, notify_shard {});
+
+        token_symbols symbols;
+        pending_refunds page;
+        page.total = static_cast<uint64_t>(readWordFromStorage(bridge_account_states_bykey, toChecksum256(STORAGE_BRIDGE_REFUND_INDEX)));
+        page.next = std::min(page.total, std::max(offset, offset + limit));
+        for(uint64_t i = offset; i < page.next; i++){
+            const auto refund_storage = storageStruct<refund_layout>(bridge_range, STORAGE_BRIDGE_REFUND_SLOT, i);
+            const uint64_t refund_id = static_cast<uint64_t>(readMember<refund_layout::id>(refund_storage));
+            if(processed_refunds.contains(refund_id)){
+                continue;
+            }
+            page.items.push_back(readRefund(refund_storage, refund_id, symbols));
+        }
+        return page;
+    };
+
+    // Lists the PairBridgeRegister pairs, as stored on EVM
+    [[eosio::action, eosio::read_only]]
+    evm_pairs tokenbridge::evmpairs(uint64_t offset, uint64_t limit)
+    {
+        check(limit > 0 && limit <= MAX_QUERY_ITEMS, "Limit must be between 1 and " + std::to_string(MAX_QUERY_ITEMS));
+        auto conf = config_bridge.get();
+
+        account_state_table register_account_states(EVM_SYSTEM_CONTRACT, conf.evm_register_scope);
+        auto register_account_states_bykey = register_account_states.get_index<"bykey"_n>();
+        storage_range register_range(register_account_states_bykey);
+
+        evm_pairs page;
+        page.total = static_cast<uint64_t>(readWordFromStorage(register_account_states_bykey, toChecksum256(STORAGE_REGISTER_PAIR_INDEX)));
+        page.next = std::min(page.total, std::max(offset, offset + limit));
+        for(uint64_t i = offset; i < page.next; i++){
+            page.items.push_back(readPair(storageStruct<pair_layout>(register_range, STORAGE_REGISTER_PAIR_SLOT, i)));
+        }
+        return page;
+    };
+
+    // Dry run of reqnotify: what the next call would pay out, nothing is written or sent
+    [[eosio::action, eosio::read_only]]
+    notify_preview tokenbridge::reqpreview()
+    {
+        notify_context ctx(get_self(), config_bridge.get(), config.get(), notify_shard {});
+        notify_preview preview;
+        preview.result = processRequests(ctx, ctx.arrayLength(STORAGE_BRIDGE_REQUEST_INDEX, "No requests found"), &preview.items);
+        return preview;
+    };
+
+    //======================== EVM storage decoding ========================
+    // Decodes a Request of the TokenBridge requests[] array, its id was read already & requested_at is never read
+    // Members are read in slot order, so a storage_range walks them row after row
+    template <typename T>
+    pending_request tokenbridge::readRequest(const storage_struct<request_layout, T>& request_storage, uint64_t call_id, token_symbols& symbols)
+    {
+        pending_request request;
+        request.index = request_storage.i;
+        request.call_id = call_id;
+        request.sender = readMember<request_layout::sender>(request_storage);
+        const uint256_t evm_amount = readMember<request_layout::amount>(request_storage);
+        request.token_contract = parseNameFromStorage(readMember<request_layout::antelope_token>(request_storage));
+        const eosio::symbol_code antelope_symbol = parseSymbolCodeFromStorage(readMember<request_layout::antelope_symbol>(request_storage));
+        request.receiver = parseNameFromStorage(readMember<request_layout::receiver>(request_storage));
+        const uint64_t evm_decimals = readMember<request_layout::evm_decimals>(request_storage);
+
+        // Get token from token stat table (and not EVM Register, in case the token issuer changes precision)
+        const eosio::symbol antelope_token = symbols.get(request.token_contract, antelope_symbol);
+
+        // We made sure on the tEVM side that the max precision for bridging matches antelope and that the wei amount to bridge (minus precision) is =< uint64_t max of 18446744073709551615
+        const uint64_t amount = toAntelopeAmount(evm_amount, antelope_token.precision(), evm_decimals);
+        request.quantity = asset(amount, antelope_token);
+        return request;
+    }
+
+    // Decodes a Refund of the TokenBridge refunds[] array, its id was read already
+    template <typename T>
+    pending_refund tokenbridge::readRefund(const storage_struct<refund_layout, T>& refund_storage, uint64_t refund_id, token_symbols& symbols)
+    {
+        pending_refund refund;
+        refund.index = refund_storage.i;
+        refund.refund_id = refund_id;
+        const uint256_t evm_amount = readMember<refund_layout::amount>(refund_storage);
+        refund.token_contract = parseNameFromStorage(readMember<refund_layout::antelope_token>(refund_storage));
+        const eosio::symbol_code antelope_symbol = parseSymbolCodeFromStorage(readMember<refund_layout::antelope_symbol>(refund_storage));
+        refund.receiver = parseNameFromStorage(readMember<refund_layout::receiver>(refund_storage));
+        const uint64_t evm_decimals = readMember<refund_layout::evm_decimals>(refund_storage);
+
+        // Get token from token stat table (and not EVM Register, in case the token issuer changes precision)
+        const std::optional<eosio::symbol> antelope_token = symbols.find(refund.token_contract, antelope_symbol);
+        if(!antelope_token.has_value()){
+            refund.quantity = asset();
+            refund.resolved = false;
+            return refund;
+        }
+
+        // Get amount according to decimal places on each chain
+        const uint64_t amount = toAntelopeAmount(evm_amount, antelope_token->precision(), evm_decimals);
+        refund.quantity = asset(amount, *antelope_token);
+        return refund;
+    }
+
+    // Decodes a Pair of the PairBridgeRegister pairs[] array
+    template <typename T>
+    evm_pair tokenbridge::readPair(const storage_struct<pair_layout, T>& pair_storage)
+    {
+        evm_pair pair;
+        pair.index = pair_storage.i;
+        pair.active = readMember<pair_layout::active>(pair_storage);
+        pair.id = static_cast<uint64_t>(requireMember<pair_layout::id>(pair_storage, "Pair id not found"));
+        pair.evm_address = requireMember<pair_layout::evm_address>(pair_storage, "Pair EVM address not found");
+        pair.evm_decimals = static_cast<uint8_t>(readMember<pair_layout::evm_decimals>(pair_storage));
+        pair.antelope_decimals = static_cast<uint8_t>(readMember<pair_layout::antelope_decimals>(pair_storage));
+        pair.issuer = parseNameFromStorage(readMember<pair_layout::antelope_issuer_name>(pair_storage));
+        // Get the account name & symbol strings from EVM Storage, decoded in place as any EOSIO name or symbol is < 32 bytes
+        pair.account = parseNameFromStorage(requireMember<pair_layout::antelope_account_name>(pair_storage, "Pair account name not found"));
+        pair.symbol = parseSymbolCodeFromStorage(requireMember<pair_layout::antelope_symbol_name>(pair_storage, "Pair symbol not found"));
+        // EVM token symbol & name can be any length
+        pair.evm_symbol = readStringMember<pair_layout::evm_symbol>(pair_storage);
+        pair.evm_name = readStringMember<pair_layout::evm_name>(pair_storage);
+        return pair;
+    }
+
     // Verify token & sign tEVM registration request
     // Todo:: replace uint64_t by uint256_t request_id
     [[eosio::action]]
@@ -403,10 +902,8 @@ namespace evm_bridge
         auto conf = config_bridge.get();
         auto evm_conf = config.get();
 
-        // Find the EVM account of this contract
-        account_table _accounts(EVM_SYSTEM_CONTRACT, EVM_SYSTEM_CONTRACT.value);
-        auto accounts_byaccount = _accounts.get_index<"byaccount"_n>();
-        auto evm_account = accounts_byaccount.require_find(get_self().value, "No EVM account found for token.brdg");
+        // Find the EVM account of this contract & its next nonce
+        nonce_allocator nonces(get_self());
 
         // Get token info from eosio.token stat table
         eosio_tokens token_row(account, symbol.code().raw());
@@ -419,63 +916,33 @@ namespace evm_bridge
         account_state_table register_account_states(EVM_SYSTEM_CONTRACT, conf.evm_register_scope);
         auto register_account_states_bykey = register_account_states.get_index<"bykey"_n>();
 
-        // Get array slot to find Token tokens[] array length
-        auto pair_storage_key = toChecksum256(STORAGE_REGISTER_PAIR_INDEX);
-        auto pair_array_length = register_account_states_bykey.find(pair_storage_key);
-        auto pair_array_slot = checksum256ToValue(keccak_256(pair_storage_key.extract_as_byte_array()));
-
-        // Get array slot to find Request requests[] array length
-        auto request_storage_key = toChecksum256(STORAGE_REGISTER_REQUEST_INDEX);
-        auto request_array_length = register_account_states_bykey.find(request_storage_key);
-        auto request_array_slot = checksum256ToValue(keccak_256(request_storage_key.extract_as_byte_array()));
-
-        // Check token doesn't already exist in EVM Register
-        // Get each member of the Pair pairs[] array's antelope_account and compare
-        for(uint64_t i = 0; i < pair_array_length->value; i++){
-            const auto symbol_name = register_account_states_bykey.find(getArrayMemberSlot(pair_array_slot, 5, 10, i));
-            if(parseSymbolCodeFromStorage(symbol_name->value).raw() == symbol.code().raw()){
-                check(false, "The token is already registered");
-            }
-        }
-        // Get each member of the Request requests[] array's antelope_account and compare.
-        // Todo: what happens if registration requests are flooded ??? This can fail to CPU... Maybe just let EVM handle that check on signing ?
-        for(uint256_t k = 0; k < request_array_length->value; k=k+1){
-            const auto symbol_name = register_account_states_bykey.find(getArrayMemberSlot(request_array_slot, 8, 11, k));
-            if(parseSymbolCodeFromStorage(symbol_name->value).raw() == symbol.code().raw()){
-                check(false, "The token is already awaiting approval");
-            }
-        }
-
-        // Prepare EVM contract address
-        auto evm_contract = conf.evm_register_address.extract_as_byte_array();
-        std::vector<uint8_t> to;
-        to.insert(to.end(),  evm_contract.begin(), evm_contract.end());
-
-        // Prepare Solidity function call (function signature + arguments)
-        std::vector<uint8_t> data;
-
-        // Add function signature
-        auto fnsig = toBin(EVM_SIGN_REGISTRATION_SIGNATURE);
-        data.insert(data.end(), fnsig.begin(), fnsig.end());
-
-        // Add integers argument
-        std::vector<uint8_t> decimals_bs = pad(intx::to_byte_string(uint256_t(symbol.precision())), 32, true);
-        std::vector<uint8_t> request_id_bs = pad(intx::to_byte_string(request_id), 16, true);
-        data.insert(data.end(), request_id_bs.begin(), request_id_bs.end());
-        data.insert(data.end(), decimals_bs.begin(), decimals_bs.end());
+        // Check token doesn't already exist in EVM Register, from its symbol indexes: one read each however many pairs & requests there are
+        const std::string symbol_name = symbol.code().to_string();
+        const uint256_t pair_index = readWordFromStorage(register_account_states_bykey, toChecksum256(getMappingSlot(symbol_name, STORAGE_REGISTER_PAIR_BY_SYMBOL_INDEX)));
+        check(pair_index == 0, "The token is already registered");
+        const uint256_t request_index = readWordFromStorage(register_account_states_bykey, toChecksum256(getMappingSlot(symbol_name, STORAGE_REGISTER_REQUEST_BY_SYMBOL_INDEX)));
+        check(request_index == 0, "The token is already awaiting approval");
 
-        // Add strings argument
-        insertElementPositions(&data, 160, 224, 288); // Our 3 strings positions
-        insertString(&data, account.to_string(), account.to_string().length());
-        insertString(&data, token->issuer.to_string(), token->issuer.to_string().length());
-        insertString(&data, symbol.code().to_string(), symbol.code().to_string().length());
+        // Prepare Solidity function call: signRegistrationRequest(id, decimals, account, issuer, symbol)
+        const std::string account_name = account.to_string();
+        const std::string issuer_name = token->issuer.to_string();
+        const std::vector<uint8_t> data = EVM_SIGN_REGISTRATION_CALL.encode(request_id, symbol.precision(), account_name, issuer_name, symbol_name);
+        const uint64_t gas = config_settings.get_or_default().register_gas.limit(0, account_name.size() + issuer_name.size() + symbol_name.size());
 
         // Send signRegistrationRequest call to EVM using eosio.evm
         action(
             permission_level {get_self(), "active"_n},
             EVM_SYSTEM_CONTRACT,
             "raw"_n,
-            std::make_tuple(get_self(), rlp::encode(evm_account->nonce, evm_conf.gas_price, SIGN_REGISTRATION_GAS, to, uint256_t(0), data, CURRENT_CHAIN_ID, 0, 0),  false, std::optional<eosio::checksum160>(evm_account->address))
+            std::make_tuple(get_self(), encodeTransaction(nonces.reserve(), evm_conf.gas_price, gas, conf.evm_register_address, uint256_t(0), data, CURRENT_CHAIN_ID),  false, std::optional<eosio::checksum160>(nonces.address))
         ).send();
+        nonces.save();
+
+        // Record metrics
+        stats_recorder recorder(get_self());
+        recorder.delta.registrations_signed = 1;
+        recorder.delta.slots_read = 2;
+        recorder.delta.inline_actions = 1;
+        recorder.save();
     };
 }
@@ -0,0 +1,9 @@
+#! /bin/bash
+echo ">>> Calling syncpairs() ..."
+if [ "$1" == "mainnet" ]
+then
+  url="https://mainnet.telos.caleos.io"
+else
+  url="https://testnet.telos.caleos.io"
+fi
+cleos --url "$url" push action token.brdg syncpairs '{"max": 10}' -p token.brdg
\ No newline at end of file
@@ -78,6 +78,105 @@ describe("token.brdg.cpp test", () => {
                 "missing authority of token.brdg"
             );
         });
+        it("Should let admin set the notify limits", async () => {
+            bridge.action.setnotify(
+                { "max_items" : 10, "max_cost" : 200 },
+                [{ actor: bridgeAccount.name, permission: "active" }]
+            );
+        });
+        it("Should not let random accounts set the notify limits", async () => {
+            await expectThrow(
+                bridge.action.setnotify(
+                    { "max_items" : 10, "max_cost" : 200 },
+                    [{ actor: account.name, permission: "active" }]
+                ),
+                "missing authority of token.brdg"
+            );
+        });
+        it("Should not let admin set a max of 0 notify items", async () => {
+            await expectThrow(
+                bridge.action.setnotify(
+                    { "max_items" : 0, "max_cost" : 200 },
+                    [{ actor: bridgeAccount.name, permission: "active" }]
+                ),
+                "Max items must be above 0"
+            );
+        });
+        it("Should not let random accounts drop the legacy rows", async () => {
+            await expectThrow(
+                bridge.action.droplegacy(
+                    { "max" : 10 },
+                    [{ actor: account.name, permission: "active" }]
+                ),
+                "missing authority of token.brdg"
+            );
+        });
+        it("Should not let admin drop a max of 0 legacy rows", async () => {
+            await expectThrow(
+                bridge.action.droplegacy(
+                    { "max" : 0 },
+                    [{ actor: bridgeAccount.name, permission: "active" }]
+                ),
+                "Max rows must be above 0"
+            );
+        });
+        it("Should let admin set the bridge batch size", async () => {
+            bridge.action.setbatch(
+                { "batch_size" : 0 },
+                [{ actor: bridgeAccount.name, permission: "active" }]
+            );
+        });
+        it("Should not let random accounts set the bridge batch size", async () => {
+            await expectThrow(
+                bridge.action.setbatch(
+                    { "batch_size" : 10 },
+                    [{ actor: account.name, permission: "active" }]
+                ),
+                "missing authority of token.brdg"
+            );
+        });
+        it("Should not let admin set a bridge batch size above the max", async () => {
+            await expectThrow(
+                bridge.action.setbatch(
+                    { "batch_size" : 51 },
+                    [{ actor: bridgeAccount.name, permission: "active" }]
+                ),
+                "Batch size is above the max batch size"
+            );
+        });
+        it("Should let admin set the gas model of an EVM call", async () => {
+            bridge.action.setgas(
+                { "call" : "bridge", "base" : 60000, "per_item" : 120000, "per_byte" : 700 },
+                [{ actor: bridgeAccount.name, permission: "active" }]
+            );
+        });
+        it("Should not let random accounts set the gas model of an EVM call", async () => {
+            await expectThrow(
+                bridge.action.setgas(
+                    { "call" : "bridge", "base" : 60000, "per_item" : 120000, "per_byte" : 700 },
+                    [{ actor: account.name, permission: "active" }]
+                ),
+                "missing authority of token.brdg"
+            );
+        });
+        it("Should not let admin set the gas model of an unknown EVM call", async () => {
+            await expectThrow(
+                bridge.action.setgas(
+                    { "call" : "mint", "base" : 60000, "per_item" : 0, "per_byte" : 0 },
+                    [{ actor: bridgeAccount.name, permission: "active" }]
+                ),
+                "Call must be bridge, success, refund or register"
+            );
+        });
+        it("Should not let admin set a base gas of 0", async () => {
+            await expectThrow(
+                bridge.action.setgas(
+                    { "call" : "success", "base" : 0, "per_item" : 50000, "per_byte" : 0 },
+                    [{ actor: bridgeAccount.name, permission: "active" }]
+                ),
+                "Base gas must be above 0"
+            );
+        });
         it("Should let admin set the version", async () => {
             bridge.action.setversion(
                 { "new_version" : "2" },
@@ -99,10 +198,30 @@ describe("token.brdg.cpp test", () => {
             // Todo: find way to have EVM test deployment on same network or mock it
         });
     });
+    describe(":: Pairs cache", function () {
+        it("Should not let syncpairs be called with a max of 0", async () => {
+            await expectThrow(
+                bridge.action.syncpairs(
+                    { "max" : 0 },
+                    [{ actor: account.name, permission: "active" }]
+                ),
+                "Max pairs to sync must be above 0"
+            );
+        });
+    });
     describe(":: Bridge to EVM", function () {
         it("Should let users bridge a eosio.token token with a registered pair to its paired token on EVM", async () => {
             // Todo: find way to have EVM test deployment on same network or mock it
         });
+        it("Should revert flush if no deposits are queued", async () => {
+            await expectThrow(
+                bridge.action.flush(
+                    { "max" : 10 },
+                    [{ actor: account.name, permission: "active" }]
+                ),
+                "No deposits to flush"
+            );
+        });
     });
     describe(":: Bridge from EVM", function () {
         it("Should let anyone notify of a bridging request on EVM", async () => {
@@ -112,7 +231,7 @@ describe("token.brdg.cpp test", () => {
             // Todo: find way to have EVM test deployment on same network or mock it
             await expectThrow(
                 bridge.action.reqnotify(
-                    {},
+                    { "shard_id" : 0, "shard_count" : 1 },
                     [{ actor: account.name, permission: "active" }]
                 ),
                 "No requests found"
@@ -125,11 +244,47 @@ describe("token.brdg.cpp test", () => {
             // Todo: find way to have EVM test deployment on same network or mock it
             await expectThrow(
                 bridge.action.refundnotify(
-                    {},
+                    { "shard_id" : 0, "shard_count" : 1 },
                     [{ actor: account.name, permission: "active" }]
                 ),
                 "No refunds found"
             );
         });
+        it("Should revert process if neither requests nor refunds are found on EVM", async () => {
+            await expectThrow(
+                bridge.action.process(
+                    { "shard_id" : 0, "shard_count" : 1 },
+                    [{ actor: account.name, permission: "active" }]
+                ),
+                "No requests or refunds found"
+            );
+        });
+        it("Should not let a crank pass a shard id above its shard count", async () => {
+            await expectThrow(
+                bridge.action.reqnotify(
+                    { "shard_id" : 2, "shard_count" : 2 },
+                    [{ actor: account.name, permission: "active" }]
+                ),
+                "Shard id must be below the shard count"
+            );
+        });
+        it("Should not let a crank pass a shard count of 0", async () => {
+            await expectThrow(
+                bridge.action.process(
+                    { "shard_id" : 0, "shard_count" : 0 },
+                    [{ actor: account.name, permission: "active" }]
+                ),
+                "Shard count must divide 8"
+            );
+        });
+        it("Should not let a crank pass a shard count that does not divide the dedupe partitions", async () => {
+            await expectThrow(
+                bridge.action.process(
+                    { "shard_id" : 0, "shard_count" : 3 },
+                    [{ actor: account.name, permission: "active" }]
+                ),
+                "Shard count must divide 8"
+            );
+        });
     });
 });
\ No newline at end of file
@@ -52,6 +52,17 @@ contract PairBridgeRegister is Ownable {
     uint public request_validity_seconds;
     uint8 public max_requests_per_requestor;
     address public antelope_bridge_evm_address;
+    // Index + 1 of the pair or request holding a key, 0 when there is none
+    // Appended after the other state variables so their storage slots do not move, Antelope reads the first five at slots 8 to 12
+    // (pair_index_by_id at slot 12 included): keep them in place & declare new state variables after them
+    mapping(address => uint) public pair_index_by_token;
+    mapping(string => uint) public pair_index_by_antelope_account;
+    mapping(string => uint) public pair_index_by_antelope_symbol;
+    mapping(string => uint) public request_index_by_antelope_symbol;
+    mapping(uint => uint) pair_index_by_id;
+    mapping(uint => uint) request_index_by_id;
+    mapping(address => uint) request_index_by_token;
+    mapping(string => uint) request_index_by_antelope_account;
 
     constructor(address _antelope_bridge_evm_address, uint8 _max_requests_per_requestor, uint _request_validity_seconds) {
         pair_id = 1;
@@ -86,29 +97,24 @@ contract PairBridgeRegister is Ownable {
 
     // GETTERS
     function _getPair(uint id) internal view returns (Pair storage) {
-        for(uint i = 0; i < pairs.length;i++){
-            if(id == pairs[i].id){
-                return pairs[i];
-            }
-        }
-        revert('Pair not found');
+        uint index = pair_index_by_id[id];
+        require(index > 0, 'Pair not found');
+        return pairs[index - 1];
+    }
+    function _requestIndex(uint id) internal view returns (uint) {
+        uint index = request_index_by_id[id];
+        require(index > 0, 'Request not found');
+        return index - 1;
     }
     function getPair(address token) external view returns (Pair memory) {
-        for(uint i = 0; i < pairs.length;i++){
-            if(token == pairs[i].evm_address){
-                return pairs[i];
-            }
-        }
-        revert('Pair not found');
+        uint index = pair_index_by_token[token];
+        require(index > 0, 'Pair not found');
+        return pairs[index - 1];
     }
     function getPairByAntelopeAccount(string calldata _antelope_account_name) external view returns (Pair memory) {
-        bytes32 account_name = keccak256(abi.encodePacked(_antelope_account_name));
-        for(uint i = 0; i < pairs.length;i++){
-            if(account_name == keccak256(abi.encodePacked(pairs[i].antelope_account_name))){
-                return pairs[i];
-            }
-        }
-        revert('Pair not found');
+        uint index = pair_index_by_antelope_account[_antelope_account_name];
+        require(index > 0, 'Pair not found');
+        return pairs[index - 1];
     }
 
     // REQUEST   ================================================================ >
@@ -139,6 +145,8 @@ contract PairBridgeRegister is Ownable {
 
         // Add a token pair registration request
         requests.push(Request(request_id, msg.sender, address(token), evm_decimals, block.timestamp, uint(0), "", "", "", evm_symbol, evm_name ));
+        request_index_by_id[request_id] = requests.length;
+        request_index_by_token[address(token)] = requests.length;
         emit RegistrationRequested(request_id, msg.sender, address(token), evm_symbol, evm_name);
         request_id++;
         request_counts[msg.sender]++;
@@ -151,37 +159,55 @@ contract PairBridgeRegister is Ownable {
         require(_antelopeTokenPairExists(_antelope_account_name) == false, "Antelope token already in a pair");
         require(_isEosioName(_antelope_symbol), "Symbol must be an eosio name");
         require(_isEosioName(_antelope_account_name), "Account must be an eosio name");
-        for(uint i = 0; i < requests.length ;i++){
-            if(requests[i].id == id){
-               requests[i].antelope_account_name = _antelope_account_name;
-               requests[i].antelope_symbol_name = _antelope_symbol;
-               requests[i].antelope_issuer_name = _antelope_issuer_name;
-               requests[i].antelope_decimals = _antelope_decimals;
-               emit RegistrationRequestSigned(requests[i].id, requests[i].evm_address,  _antelope_account_name, _antelope_symbol, requests[i].evm_symbol, requests[i].evm_name);
-               return;
-            }
-        }
-        revert('Request not found');
+        uint i = _requestIndex(id);
+        _unindex(request_index_by_antelope_symbol, requests[i].antelope_symbol_name, i);
+        _unindex(request_index_by_antelope_account, requests[i].antelope_account_name, i);
+        requests[i].antelope_account_name = _antelope_account_name;
+        requests[i].antelope_symbol_name = _antelope_symbol;
+        requests[i].antelope_issuer_name = _antelope_issuer_name;
+        requests[i].antelope_decimals = _antelope_decimals;
+        request_index_by_antelope_symbol[_antelope_symbol] = i + 1;
+        request_index_by_antelope_account[_antelope_account_name] = i + 1;
+        emit RegistrationRequestSigned(requests[i].id, requests[i].evm_address,  _antelope_account_name, _antelope_symbol, requests[i].evm_symbol, requests[i].evm_name);
     }
 
     // Let owner or registration sender delete requests
     function removeRegistrationRequest (uint id) external {
-        for(uint i = 0;i<requests.length;i++){
-            if(requests[i].id == id){
-                require(msg.sender == owner() || msg.sender == requests[i].sender, 'Only the requestor or contract owner can invoke this method');
-                _removeRegistrationRequest(i);
-            }
+        uint index = request_index_by_id[id];
+        if(index > 0){
+            require(msg.sender == owner() || msg.sender == requests[index - 1].sender, 'Only the requestor or contract owner can invoke this method');
+            _removeRegistrationRequest(index - 1);
         }
     }
 
     function _removeRegistrationRequest (uint i) internal {
        address sender = requests[i].sender;
        emit RegistrationRequestDeleted(requests[i].id, requests[i].evm_address,  requests[i].antelope_account_name);
-       requests[i] = requests[requests.length-1];
-       requests.pop();
+       _popRegistrationRequest(i);
        request_counts[sender]--;
     }
 
+    // Swaps the last request into slot i & pops it, keeping the request indexes in step
+    function _popRegistrationRequest (uint i) internal {
+       uint last = requests.length - 1;
+       delete request_index_by_id[requests[i].id];
+       if(request_index_by_token[requests[i].evm_address] == i + 1){
+           delete request_index_by_token[requests[i].evm_address];
+       }
+       _unindex(request_index_by_antelope_symbol, requests[i].antelope_symbol_name, i);
+       _unindex(request_index_by_antelope_account, requests[i].antelope_account_name, i);
+       if(i != last){
+           requests[i] = requests[last];
+           request_index_by_id[requests[i].id] = i + 1;
+           if(request_index_by_token[requests[i].evm_address] == last + 1){
+               request_index_by_token[requests[i].evm_address] = i + 1;
+           }
+           _reindex(request_index_by_antelope_symbol, requests[i].antelope_symbol_name, last, i);
+           _reindex(request_index_by_antelope_account, requests[i].antelope_account_name, last, i);
+       }
+       requests.pop();
+    }
+
     function _removeOutdatedRegistrationRequests () internal {
         uint i = 0;
         while(i<requests.length){
@@ -196,18 +222,14 @@ contract PairBridgeRegister is Ownable {
     // Let owner, the prods.evm EVM address, approve pairs, adding them to the registry
     // returns the uint token id
     function approveRegistrationRequest (uint id) external onlyOwner returns(uint) {
-        for(uint i = 0;i<requests.length;i++){
-            if(requests[i].id == id){
-               require(requests[i].antelope_decimals > 0, "Request not signed by Antelope");
-               pairs.push(Pair(true, pair_id, requests[i].evm_address, requests[i].evm_decimals, requests[i].antelope_decimals, requests[i].antelope_issuer_name, requests[i].antelope_account_name, requests[i].antelope_symbol_name,  requests[i].evm_symbol, requests[i].evm_name));
-               emit PairAdded(pair_id, requests[i].evm_address, requests[i].evm_symbol, requests[i].evm_name, requests[i].antelope_account_name, requests[i].antelope_symbol_name);
-               requests[i] = requests[requests.length - 1];
-               requests.pop();
-               pair_id++;
-               return (pair_id - 1);
-            }
-        }
-        revert('Request not found');
+        uint i = _requestIndex(id);
+        require(requests[i].antelope_decimals > 0, "Request not signed by Antelope");
+        pairs.push(Pair(true, pair_id, requests[i].evm_address, requests[i].evm_decimals, requests[i].antelope_decimals, requests[i].antelope_issuer_name, requests[i].antelope_account_name, requests[i].antelope_symbol_name,  requests[i].evm_symbol, requests[i].evm_name));
+        _indexPair(pairs.length - 1);
+        emit PairAdded(pair_id, requests[i].evm_address, requests[i].evm_symbol, requests[i].evm_name, requests[i].antelope_account_name, requests[i].antelope_symbol_name);
+        _popRegistrationRequest(i);
+        pair_id++;
+        return (pair_id - 1);
     }
 
     // TOKEN   ================================================================ >
@@ -216,6 +238,7 @@ contract PairBridgeRegister is Ownable {
         string memory evm_symbol = evm_token.symbol();
         string memory evm_name = evm_token.name();
         pairs.push(Pair(true, pair_id, address(evm_token), evm_decimals, antelope_decimals, antelope_issuer_name, antelope_account_name, antelope_symbol_name, evm_symbol, evm_name));
+        _indexPair(pairs.length - 1);
         emit PairAdded(pair_id, address(evm_token), evm_symbol, evm_name, antelope_account_name, antelope_symbol_name);
         pair_id++;
         return (pair_id - 1);
@@ -234,15 +257,46 @@ contract PairBridgeRegister is Ownable {
     }
 
     function removePair (uint id) external onlyOwner {
-        for(uint i; i < pairs.length;i++){
-            if(pairs[i].id == id){
-               emit PairDeleted(pairs[i].id, pairs[i].evm_address, pairs[i].evm_symbol, pairs[i].evm_name, pairs[i].antelope_account_name);
-               pairs[i] = pairs[pairs.length - 1];
-               pairs.pop();
-               return;
+        uint index = pair_index_by_id[id];
+        require(index > 0, 'Pair not found');
+        uint i = index - 1;
+        emit PairDeleted(pairs[i].id, pairs[i].evm_address, pairs[i].evm_symbol, pairs[i].evm_name, pairs[i].antelope_account_name);
+        uint last = pairs.length - 1;
+        delete pair_index_by_id[id];
+        if(pair_index_by_token[pairs[i].evm_address] == i + 1){
+            delete pair_index_by_token[pairs[i].evm_address];
+        }
+        _unindex(pair_index_by_antelope_account, pairs[i].antelope_account_name, i);
+        _unindex(pair_index_by_antelope_symbol, pairs[i].antelope_symbol_name, i);
+        if(i != last){
+            pairs[i] = pairs[last];
+            pair_index_by_id[pairs[i].id] = i + 1;
+            if(pair_index_by_token[pairs[i].evm_address] == last + 1){
+                pair_index_by_token[pairs[i].evm_address] = i + 1;
             }
+            _reindex(pair_index_by_antelope_account, pairs[i].antelope_account_name, last, i);
+            _reindex(pair_index_by_antelope_symbol, pairs[i].antelope_symbol_name, last, i);
+        }
+        pairs.pop();
+    }
+
+    // INDEXES   ================================================================ >
+    function _indexPair(uint i) internal {
+        pair_index_by_id[pairs[i].id] = i + 1;
+        pair_index_by_token[pairs[i].evm_address] = i + 1;
+        pair_index_by_antelope_account[pairs[i].antelope_account_name] = i + 1;
+        pair_index_by_antelope_symbol[pairs[i].antelope_symbol_name] = i + 1;
+    }
+    // Only drops keys still pointing at index i, another pair or request may hold the same one
+    function _unindex(mapping(string => uint) storage index, string storage key, uint i) internal {
+        if(index[key] == i + 1){
+            delete index[key];
+        }
+    }
+    function _reindex(mapping(string => uint) storage index, string storage key, uint from, uint to) internal {
+        if(index[key] == from + 1){
+            index[key] = to + 1;
         }
-        revert('Pair not found');
     }
 
     // UTILS   ================================================================ >
@@ -261,33 +315,12 @@ contract PairBridgeRegister is Ownable {
         }
     }
     function _antelopeTokenPairExists(string calldata account_name) internal view returns (bool) {
-        bytes32 account =  keccak256(abi.encodePacked(account_name));
-        for(uint i = 0; i < pairs.length;i++){
-            if(account == keccak256(abi.encodePacked(pairs[i].antelope_account_name)) ){
-                return true;
-            }
-        }
-        for(uint k = 0; k < requests.length;k++){
-            if(account == keccak256(abi.encodePacked(requests[k].antelope_account_name)) ){
-                return true;
-            }
-        }
-        return false;
+        return pair_index_by_antelope_account[account_name] > 0 || request_index_by_antelope_account[account_name] > 0;
     }
     function _tokenPairExists(address token) internal view returns (bool) {
-        for(uint i = 0; i < pairs.length;i++){
-            if(token == pairs[i].evm_address){
-                return true;
-            }
-        }
-        return false;
+        return pair_index_by_token[token] > 0;
     }
     function _tokenPairRegistrationExists(address token) internal view returns (bool) {
-        for(uint i = 0; i < requests.length;i++){
-            if(token == requests[i].evm_address){
-                return true;
-            }
-        }
-        return false;
+        return request_index_by_token[token] > 0;
     }
 }
\ No newline at end of file
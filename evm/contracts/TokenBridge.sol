@@ -57,13 +57,18 @@ contract TokenBridge is Ownable {
         uint8 evm_decimals;
     }
 
-    Refund[] refunds;
+    Refund[] public refunds;
 
     mapping(address => uint) public request_counts;
     uint request_id;
     uint refund_id;
     uint public min_amount;
 
+    // Index + 1 of the request or refund holding an id, 0 when there is none
+    // Appended after the other state variables so the storage slots Antelope reads do not move
+    mapping(uint => uint) request_index_by_id;
+    mapping(uint => uint) refund_index_by_id;
+
     constructor(address _antelope_bridge_evm_address, IPairBridgeRegister _pair_register,  uint8 _max_requests_per_requestor, uint _fee, uint _min_amount) {
         fee = _fee;
         min_amount = _min_amount;
@@ -101,40 +106,74 @@ contract TokenBridge is Ownable {
      // MAIN   ================================================================ >
      // SUCCESS ANTELOPE CALLBACK
      function requestSuccessful(uint id) external onlyAntelopeBridge {
-        for(uint i = 0; i < requests.length; i++){
-            if(requests[i].id == id){
-                emit BridgeToAntelopeSucceeded(id, requests[i].sender, requests[i].antelope_token, requests[i].amount, requests[i].receiver);
-                _removeRequest(i);
-            }
+        _requestSuccessful(id);
+     }
+
+     // SUCCESS ANTELOPE CALLBACK, for every request paid out by one Antelope action
+     function requestsSuccessful(uint[] calldata ids) external onlyAntelopeBridge {
+        for(uint k = 0; k < ids.length; k++){
+            _requestSuccessful(ids[k]);
+        }
+     }
+
+     function _requestSuccessful(uint id) internal {
+        uint index = request_index_by_id[id];
+        if(index == 0){
+            return;
         }
+        Request storage request = requests[index - 1];
+        emit BridgeToAntelopeSucceeded(id, request.sender, request.antelope_token, request.amount, request.receiver);
+        _removeRequest(index - 1);
      }
 
      // REFUND ANTELOPE CALLBACK
      function refundSuccessful(uint id) external onlyAntelopeBridge {
-        for(uint i = 0; i < requests.length; i++){
-            if(refunds[i].id == id){
-                refunds[i] = refunds[requests.length - 1];
-                emit BridgeFromAntelopeRefunded(id);
-                refunds.pop();
-            }
+        _refundSuccessful(id);
+     }
+
+     // REFUND ANTELOPE CALLBACK, for every refund paid back by one Antelope action
+     function refundsSuccessful(uint[] calldata ids) external onlyAntelopeBridge {
+        for(uint k = 0; k < ids.length; k++){
+            _refundSuccessful(ids[k]);
+        }
+     }
+
+     function _refundSuccessful(uint id) internal {
+        uint index = refund_index_by_id[id];
+        if(index == 0){
+            return;
+        }
+        uint i = index - 1;
+        uint last = refunds.length - 1;
+        delete refund_index_by_id[id];
+        if(i != last){
+            refunds[i] = refunds[last];
+            refund_index_by_id[refunds[i].id] = index;
         }
+        emit BridgeFromAntelopeRefunded(id);
+        refunds.pop();
      }
 
+     // Swaps the last request into slot i & pops it, keeping the id index in step
      function _removeRequest(uint i) internal {
         address sender = requests[i].sender;
-        requests[i] = requests[requests.length - 1];
+        uint last = requests.length - 1;
+        delete request_index_by_id[requests[i].id];
+        if(i != last){
+            requests[i] = requests[last];
+            request_index_by_id[requests[i].id] = i + 1;
+        }
         requests.pop();
         request_counts[sender]--;
      }
 
      function removeRequest(uint id) external onlyAntelopeBridge returns (bool) {
-        for(uint i = 0; i < requests.length; i++){
-            if(requests[i].id == id){
-                _removeRequest(i);
-                return true;
-            }
+        uint index = request_index_by_id[id];
+        if(index == 0){
+            return false;
         }
-        return false;
+        _removeRequest(index - 1);
+        return true;
      }
 
      // FROM ANTELOPE BRIDGE
@@ -147,11 +186,48 @@ contract TokenBridge is Ownable {
             emit BridgeFromAntelopeSucceeded(receiver, token, amount);
         } catch {
             // Could not mint for whatever reason... Refund the Antelope tokens
-            emit BridgeFromAntelopeFailed(receiver, token, amount, sender);
-            refunds.push(Refund(refund_id, amount, pairData.antelope_account_name, pairData.antelope_symbol_name, sender, pairData.evm_decimals));
+            _refund(pairData, token, receiver, amount, sender);
+        }
+     }
+
+     // Several bridgeTo in one call: an item whose pair is paused, removed or that cannot be minted is refunded instead of reverting the others
+     // Antelope passes the token account & symbol each item came from, so an item whose pair left the register still has a token to refund
+     function bridgeToBatch(address[] calldata tokens, address[] calldata receivers, uint[] calldata amounts, string[] calldata senders, string[] calldata antelope_tokens, string[] calldata antelope_symbols) external onlyAntelopeBridge {
+        require(tokens.length == receivers.length && tokens.length == amounts.length && tokens.length == senders.length && tokens.length == antelope_tokens.length && tokens.length == antelope_symbols.length, "Batch arrays must have the same length");
+        for(uint i = 0; i < tokens.length; i++){
+            _bridgeToItem(tokens[i], receivers[i], amounts[i], senders[i], antelope_tokens[i], antelope_symbols[i]);
         }
      }
 
+     // One item of a batch, in its own frame so the batch arrays do not run the stack too deep
+     function _bridgeToItem(address token, address receiver, uint amount, string calldata sender, string calldata antelope_token, string calldata antelope_symbol) internal {
+        IPairBridgeRegister.Pair memory pairData;
+        try pair_register.getPair(token) returns (IPairBridgeRegister.Pair memory pair) {
+            pairData = pair;
+        } catch {
+            // Removed from the register: refund to the Antelope token the deposit came from
+            pairData.antelope_account_name = antelope_token;
+            pairData.antelope_symbol_name = antelope_symbol;
+            try IERC20Bridgeable(token).decimals() returns (uint8 token_decimals) {
+                pairData.evm_decimals = token_decimals;
+            } catch {}
+        }
+        if(pairData.active){
+            try IERC20Bridgeable(token).mint(receiver, amount) {
+                emit BridgeFromAntelopeSucceeded(receiver, token, amount);
+                return;
+            } catch {}
+        }
+        _refund(pairData, token, receiver, amount, sender);
+     }
+
+     function _refund(IPairBridgeRegister.Pair memory pairData, address token, address receiver, uint amount, string calldata sender) internal {
+        emit BridgeFromAntelopeFailed(receiver, token, amount, sender);
+        refunds.push(Refund(refund_id, amount, pairData.antelope_account_name, pairData.antelope_symbol_name, sender, pairData.evm_decimals));
+        refund_index_by_id[refund_id] = refunds.length;
+        refund_id++;
+     }
+
      // TO ANTELOPE
      function bridge(IERC20Bridgeable token, uint amount, string calldata receiver) external payable {
         // Checks
@@ -189,6 +265,7 @@ contract TokenBridge is Ownable {
         try token.burnFrom(msg.sender, amount){
             // Add a request to be picked up and processed by the Antelope side
             requests.push(Request (request_id, msg.sender, amount, block.timestamp, pairData.antelope_account_name, pairData.antelope_symbol_name, receiver, pairData.evm_decimals));
+            request_index_by_id[request_id] = requests.length;
             emit BridgeToAntelopeRequested(request_id, msg.sender, address(token), pairData.antelope_account_name, amount, receiver);
             request_id++;
             request_counts[msg.sender]++;
@@ -0,0 +1,184 @@
+const { ethers } = require("hardhat");
+const { expect } = require("chai");
+const ONE_TLOS = ethers.utils.parseEther("1.0");
+const HALF_TLOS = ethers.utils.parseEther("0.5");
+const TOKEN_NAME = "My Bridgeable Token";
+const TOKEN_SYMBOL = "MBT";
+const MAX_REQUESTS = 255;
+const REQUEST_VALIDITY = 3600; // 1h
+const ANTELOPE_ISSUER_NAME = "mysender";
+const ANTELOPE_DECIMALS = 4;
+const ZERO_ADDRESS = "0x0000000000000000000000000000000000000000";
+const PAIR_COUNTS = [1, 10, 50];
+const BATCH_SIZES = [1, 10, 50];
+const QUEUE_DEPTHS = [2, 10, 50];
+const NAMES = ["a", "abcdef", "abcdefghijkl"]; // 1, 6 & 12 bytes eosio names
+const MARGIN = 1.1; // headroom added to the fitted figures
+
+// Gas used by a sent transaction
+async function gasUsed(tx){
+    return (await (await tx).wait()).gasUsed.toNumber();
+}
+
+// Smallest base & per unit gas covering every [units, gas] measure, keeping the worst measure of each unit count
+function fit(measures){
+    const worst = {};
+    for(const [units, gas] of measures){
+        worst[units] = Math.max(worst[units] || 0, gas);
+    }
+    const points = Object.keys(worst).map(Number).sort((a, b) => a - b).map(units => [units, worst[units]]);
+    let per_unit = 0;
+    for(let i = 1; i < points.length; i++){
+        per_unit = Math.max(per_unit, Math.ceil((points[i][1] - points[i - 1][1]) / (points[i][0] - points[i - 1][0])));
+    }
+    const base = Math.max(...points.map(([units, gas]) => gas - per_unit * units));
+    return { base, per_unit };
+}
+
+// A distinct eosio name for the i-th pair
+function antelopeName(prefix, i){
+    return prefix + String.fromCharCode(97 + i % 26) + String.fromCharCode(97 + Math.floor(i / 26) % 26);
+}
+
+// Measures the gas of each EVM entrypoint token.brdg calls across pair counts, queue depths & string lengths
+// Run with `npm run profile:gas`, it prints the `setgas` figures of each call type
+(process.env.GAS_PROFILE ? describe : describe.skip)("Gas profile", function () {
+    this.timeout(0);
+    let antelope_bridge, user, register, evm_bridge, tokens;
+    const models = {};
+
+    async function deploy(pair_count){
+        [antelope_bridge, user] = await ethers.getSigners();
+        let PairRegister = await ethers.getContractFactory("PairBridgeRegister");
+        register = await PairRegister.deploy(antelope_bridge.address, MAX_REQUESTS, REQUEST_VALIDITY);
+        let EVMBridge = await ethers.getContractFactory("TokenBridge");
+        evm_bridge = await EVMBridge.deploy(antelope_bridge.address, register.address, MAX_REQUESTS, HALF_TLOS, HALF_TLOS);
+        let ERC20Bridgeable = await ethers.getContractFactory("ERC20Bridgeable");
+        tokens = [];
+        for(var i = 0; i < pair_count; i++){
+            const token = await ERC20Bridgeable.deploy(evm_bridge.address,  TOKEN_NAME + i, TOKEN_SYMBOL + i);
+            await register.addPair(token.address, ANTELOPE_DECIMALS, ANTELOPE_ISSUER_NAME, antelopeName("token", i), antelopeName("SYM", i).toUpperCase());
+            tokens.push(token);
+        }
+    }
+
+    // Queues `count` bridge requests to Antelope from user, all for the last pair
+    async function queueRequests(count){
+        const token = tokens[tokens.length - 1];
+        await evm_bridge.connect(antelope_bridge).bridgeTo(token.address, user.address, ONE_TLOS.mul(count), ANTELOPE_ISSUER_NAME);
+        await token.connect(user).approve(evm_bridge.address, ONE_TLOS.mul(count));
+        for(var i = 0; i < count; i++){
+            await evm_bridge.connect(user).bridge(token.address, ONE_TLOS, ANTELOPE_ISSUER_NAME, {value: HALF_TLOS});
+        }
+    }
+
+    it("bridgeTo, per sender name byte" , async function () {
+        const measures = [];
+        for(const pair_count of PAIR_COUNTS){
+            await deploy(pair_count);
+            const token = tokens[tokens.length - 1];
+            for(const name of NAMES){
+                measures.push([name.length, await gasUsed(evm_bridge.connect(antelope_bridge).bridgeTo(token.address, user.address, ONE_TLOS, name))]);
+                // A receiver that cannot be minted to makes a refund, the costlier path
+                measures.push([name.length, await gasUsed(evm_bridge.connect(antelope_bridge).bridgeTo(token.address, ZERO_ADDRESS, ONE_TLOS, name))]);
+            }
+        }
+        const { base, per_unit } = fit(measures);
+        models.bridge = { single: base, per_byte: per_unit };
+        console.table(measures.map(([bytes, gas]) => ({ bytes, gas })));
+        for(const [bytes, gas] of measures){
+            expect(base + per_unit * bytes).to.be.gte(gas);
+        }
+    });
+    it("bridgeToBatch, per deposit" , async function () {
+        const name = NAMES[NAMES.length - 1];
+        const measures = [];
+        for(const pair_count of PAIR_COUNTS){
+            await deploy(pair_count);
+            for(const size of BATCH_SIZES){
+                const batch_pairs = [...Array(size).keys()].map(i => i % tokens.length);
+                const batch_tokens = batch_pairs.map(i => tokens[i].address);
+                const amounts = Array(size).fill(ONE_TLOS);
+                const senders = Array(size).fill(name);
+                const antelope_tokens = batch_pairs.map(i => antelopeName("token", i));
+                const antelope_symbols = batch_pairs.map(i => antelopeName("SYM", i).toUpperCase());
+                // token.brdg counts the sender & Antelope token names of a batch as its string bytes
+                const string_bytes = [...senders, ...antelope_tokens, ...antelope_symbols].join("").length;
+                for(const receiver of [user.address, ZERO_ADDRESS]){
+                    const gas = await gasUsed(evm_bridge.connect(antelope_bridge).bridgeToBatch(batch_tokens, Array(size).fill(receiver), amounts, senders, antelope_tokens, antelope_symbols));
+                    measures.push([size, gas - models.bridge.per_byte * string_bytes]);
+                }
+            }
+        }
+        const { base, per_unit } = fit(measures);
+        // bridgeTo counts as a batch of one
+        models.bridge.base = Math.max(base, models.bridge.single - per_unit);
+        models.bridge.per_item = per_unit;
+        console.table(measures.map(([deposits, gas]) => ({ deposits, gas })));
+        for(const [deposits, gas] of measures){
+            expect(models.bridge.base + per_unit * deposits).to.be.gte(gas);
+        }
+    });
+    it("requestsSuccessful, per id" , async function () {
+        const measures = [];
+        for(const depth of QUEUE_DEPTHS){
+            await deploy(1);
+            await queueRequests(depth);
+            // The oldest first, so every removal swaps the last request in
+            measures.push([1, await gasUsed(evm_bridge.connect(antelope_bridge).requestsSuccessful([0]))]);
+            const ids = [...Array(depth - 1).keys()].map(i => i + 1);
+            measures.push([ids.length, await gasUsed(evm_bridge.connect(antelope_bridge).requestsSuccessful(ids))]);
+        }
+        const { base, per_unit } = fit(measures);
+        models.success = { base, per_item: per_unit, per_byte: 0 };
+        console.table(measures.map(([ids, gas]) => ({ ids, gas })));
+        for(const [ids, gas] of measures){
+            expect(base + per_unit * ids).to.be.gte(gas);
+        }
+    });
+    it("refundsSuccessful, per id" , async function () {
+        const name = NAMES[NAMES.length - 1];
+        const measures = [];
+        for(const depth of QUEUE_DEPTHS){
+            await deploy(1);
+            for(var i = 0; i < depth; i++){
+                await evm_bridge.connect(antelope_bridge).bridgeTo(tokens[0].address, ZERO_ADDRESS, ONE_TLOS, name);
+            }
+            measures.push([1, await gasUsed(evm_bridge.connect(antelope_bridge).refundsSuccessful([0]))]);
+            const ids = [...Array(depth - 1).keys()].map(i => i + 1);
+            measures.push([ids.length, await gasUsed(evm_bridge.connect(antelope_bridge).refundsSuccessful(ids))]);
+        }
+        const { base, per_unit } = fit(measures);
+        models.refund = { base, per_item: per_unit, per_byte: 0 };
+        console.table(measures.map(([ids, gas]) => ({ ids, gas })));
+        for(const [ids, gas] of measures){
+            expect(base + per_unit * ids).to.be.gte(gas);
+        }
+    });
+    it("signRegistrationRequest, per account, issuer & symbol byte" , async function () {
+        const measures = [];
+        for(const pair_count of PAIR_COUNTS){
+            await deploy(pair_count);
+            let ERC20Bridgeable = await ethers.getContractFactory("ERC20Bridgeable");
+            for(const name of NAMES){
+                const token = await ERC20Bridgeable.deploy(evm_bridge.address,  TOKEN_NAME, TOKEN_SYMBOL);
+                const receipt = await (await register.requestRegistration(token.address)).wait();
+                const id = receipt.events.find(e => e.event == 'RegistrationRequested').args.request_id;
+                const gas = await gasUsed(register.connect(antelope_bridge).signRegistrationRequest(id, ANTELOPE_DECIMALS, name, name, name.toUpperCase()));
+                measures.push([name.length * 3, gas]);
+            }
+        }
+        const { base, per_unit } = fit(measures);
+        models.register = { base, per_item: 0, per_byte: per_unit };
+        console.table(measures.map(([bytes, gas]) => ({ bytes, gas })));
+        for(const [bytes, gas] of measures){
+            expect(base + per_unit * bytes).to.be.gte(gas);
+        }
+    });
+    after(function () {
+        for(const [call, model] of Object.entries(models)){
+            const figures = [model.base, model.per_item, model.per_byte].map(gas => Math.ceil((gas || 0) * MARGIN));
+            console.log("setgas " + call + " " + figures.join(" "));
+        }
+    });
+});
@@ -120,6 +120,22 @@ describe("PairBridgeRegister Contract", function () {
             expect(await register.connect(antelope_bridge).approveRegistrationRequest(1)).to.emit('RegistrationRequestApproved');
             await expect(register.requestRegistration(token.address)).to.be.revertedWith('Token has pair already registered');
         });
+        it("Should index a signed request by Antelope symbol until it is approved" , async function () {
+            expect(await register.requestRegistration(token.address)).to.emit('RegistrationRequested');
+            expect(await register.connect(antelope_bridge).signRegistrationRequest(1, ANTELOPE_DECIMALS, ANTELOPE_ACCOUNT_NAME, ANTELOPE_ISSUER_NAME, ANTELOPE_SYMBOL)).to.emit('RegistrationRequestSigned');
+            expect(await register.request_index_by_antelope_symbol(ANTELOPE_SYMBOL)).to.equal(1);
+            expect(await register.connect(antelope_bridge).approveRegistrationRequest(1)).to.emit('RegistrationRequestApproved');
+            expect(await register.request_index_by_antelope_symbol(ANTELOPE_SYMBOL)).to.equal(0);
+            expect(await register.pair_index_by_antelope_symbol(ANTELOPE_SYMBOL)).to.equal(1);
+        });
+        it("Should find the request moved by a removal by id" , async function () {
+            expect(await register.requestRegistration(token.address)).to.emit('RegistrationRequested');
+            expect(await register.requestRegistration(token2.address)).to.emit('RegistrationRequested');
+            expect(await register.removeRegistrationRequest(1)).to.emit('RegistrationRequestDeleted');
+            expect(await register.connect(antelope_bridge).signRegistrationRequest(2, ANTELOPE_DECIMALS, ANTELOPE_ACCOUNT_NAME, ANTELOPE_ISSUER_NAME, ANTELOPE_SYMBOL)).to.emit('RegistrationRequestSigned');
+            await expect(register.connect(antelope_bridge).signRegistrationRequest(1, ANTELOPE_DECIMALS, "token1.brdg", ANTELOPE_ISSUER_NAME, ANTELOPE_SYMBOL + "B")).to.be.revertedWith('Request not found');
+            expect(await register.requestRegistration(token.address)).to.emit('RegistrationRequested');
+        });
     });
     describe(":: Pair CRUD", async function () {
         it("Should let owner add a pair" , async function () {
@@ -154,6 +170,29 @@ describe("PairBridgeRegister Contract", function () {
             expect(await register.pausePair(1)).to.emit("PairPaused");
             await expect(register.connect(user).unpausePair(1)).to.be.revertedWith("Ownable: caller is not the owner");
         });
+        it("Should index an added pair by token, Antelope account & symbol" , async function () {
+            expect(await register.addPair(token.address, ANTELOPE_DECIMALS, ANTELOPE_ISSUER_NAME, ANTELOPE_ACCOUNT_NAME, ANTELOPE_SYMBOL)).to.emit("PairAdded");
+            expect(await register.pair_index_by_token(token.address)).to.equal(1);
+            expect(await register.pair_index_by_antelope_account(ANTELOPE_ACCOUNT_NAME)).to.equal(1);
+            expect(await register.pair_index_by_antelope_symbol(ANTELOPE_SYMBOL)).to.equal(1);
+        });
+        it("Should reindex the pair moved by a removal" , async function () {
+            expect(await register.addPair(token.address, ANTELOPE_DECIMALS, ANTELOPE_ISSUER_NAME, ANTELOPE_ACCOUNT_NAME, ANTELOPE_SYMBOL)).to.emit("PairAdded");
+            expect(await register.addPair(token2.address, ANTELOPE_DECIMALS, ANTELOPE_ISSUER_NAME, "token2.brdg", ANTELOPE_SYMBOL + "B")).to.emit("PairAdded");
+            expect(await register.removePair(1)).to.emit("PairDeleted");
+            expect(await register.pair_index_by_token(token.address)).to.equal(0);
+            expect(await register.pair_index_by_antelope_account(ANTELOPE_ACCOUNT_NAME)).to.equal(0);
+            expect(await register.pair_index_by_token(token2.address)).to.equal(1);
+            expect(await register.pair_index_by_antelope_account("token2.brdg")).to.equal(1);
+            expect(await register.pair_index_by_antelope_symbol(ANTELOPE_SYMBOL + "B")).to.equal(1);
+        });
+        it("Should find the pair moved by a removal by id" , async function () {
+            expect(await register.addPair(token.address, ANTELOPE_DECIMALS, ANTELOPE_ISSUER_NAME, ANTELOPE_ACCOUNT_NAME, ANTELOPE_SYMBOL)).to.emit("PairAdded");
+            expect(await register.addPair(token2.address, ANTELOPE_DECIMALS, ANTELOPE_ISSUER_NAME, "token2.brdg", ANTELOPE_SYMBOL + "B")).to.emit("PairAdded");
+            expect(await register.removePair(1)).to.emit("PairDeleted");
+            expect(await register.pausePair(2)).to.emit("PairPaused");
+            await expect(register.removePair(1)).to.be.revertedWith('Pair not found');
+        });
     });
     describe(":: Getters", async function () {
         it("Should return an existing registered Antelope token's pair" , async function () {
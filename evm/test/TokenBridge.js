@@ -112,6 +112,25 @@ describe("TokenBridge Contract", function () {
             expect(await evm_bridge.connect(user).bridge(token.address, HALF_TLOS, ANTELOPE_ISSUER_NAME, {value: HALF_TLOS})).to.emit('BridgeToAntelopeRequested');
             await expect(evm_bridge.connect(user).requestSuccessful(0)).to.be.revertedWith('Only the Antelope bridge EVM address can trigger this method !');
         });
+        it("Should let antelope bridge set several requests as successful" , async function () {
+            expect(await evm_bridge.connect(user).bridge(token.address, HALF_TLOS, ANTELOPE_ISSUER_NAME, {value: HALF_TLOS})).to.emit('BridgeToAntelopeRequested');
+            expect(await evm_bridge.connect(user).bridge(token.address, HALF_TLOS, ANTELOPE_ISSUER_NAME, {value: HALF_TLOS})).to.emit('BridgeToAntelopeRequested');
+            await expect(evm_bridge.connect(antelope_bridge).requestsSuccessful([0, 1])).to.emit(evm_bridge, 'BridgeToAntelopeSucceeded').withArgs(1, user.address, ANTELOPE_ACCOUNT_NAME, HALF_TLOS, ANTELOPE_ISSUER_NAME);
+            await expect(evm_bridge.requests(0)).to.be.reverted;
+        });
+        it("Should find the request moved by a removal by id" , async function () {
+            for(var i = 0; i < 3; i++){
+                expect(await evm_bridge.connect(user).bridge(token.address, HALF_TLOS, ANTELOPE_ISSUER_NAME, {value: HALF_TLOS})).to.emit('BridgeToAntelopeRequested');
+            }
+            expect(await evm_bridge.connect(antelope_bridge).requestSuccessful(0)).to.emit('BridgeToAntelopeSucceeded');
+            await expect(evm_bridge.connect(antelope_bridge).requestsSuccessful([2])).to.emit(evm_bridge, 'BridgeToAntelopeSucceeded').withArgs(2, user.address, ANTELOPE_ACCOUNT_NAME, HALF_TLOS, ANTELOPE_ISSUER_NAME);
+            expect((await evm_bridge.requests(0)).id).to.equal(1);
+            await expect(evm_bridge.requests(1)).to.be.reverted;
+        });
+        it("Should not let a random address set several requests as successful" , async function () {
+            expect(await evm_bridge.connect(user).bridge(token.address, HALF_TLOS, ANTELOPE_ISSUER_NAME, {value: HALF_TLOS})).to.emit('BridgeToAntelopeRequested');
+            await expect(evm_bridge.connect(user).requestsSuccessful([0])).to.be.revertedWith('Only the Antelope bridge EVM address can trigger this method !');
+        });
         it("Should let antelope bridge remove a request" , async function () {
             expect(await evm_bridge.connect(user).bridge(token.address, HALF_TLOS, ANTELOPE_ISSUER_NAME, {value: HALF_TLOS})).to.emit('BridgeToAntelopeRequested');
             await expect(evm_bridge.connect(antelope_bridge).removeRequest(0)).to.not.be.reverted;
@@ -146,5 +165,75 @@ describe("TokenBridge Contract", function () {
             expect(await evm_bridge.connect(antelope_bridge).bridgeTo(token.address, "0x0000000000000000000000000000000000000000", ONE_TLOS, ANTELOPE_ISSUER_NAME)).to.emit('BridgeFromAntelopeFailed');
             await expect(evm_bridge.connect(user).refundSuccessful(0)).to.be.revertedWith('Only the Antelope bridge EVM address can trigger this method !');
         });
+        it("Should let antelope bridge call the refund success callback for several refunds" , async function () {
+            expect(await register.addPair(token.address, ANTELOPE_DECIMALS, ANTELOPE_ISSUER_NAME, ANTELOPE_ACCOUNT_NAME, ANTELOPE_SYMBOL_NAME)).to.emit("PairAdded");
+            expect(await evm_bridge.connect(antelope_bridge).bridgeTo(token.address, "0x0000000000000000000000000000000000000000", ONE_TLOS, ANTELOPE_ISSUER_NAME)).to.emit('BridgeFromAntelopeFailed');
+            expect(await evm_bridge.connect(antelope_bridge).bridgeTo(token.address, "0x0000000000000000000000000000000000000000", ONE_TLOS, ANTELOPE_ISSUER_NAME)).to.emit('BridgeFromAntelopeFailed');
+            await expect(evm_bridge.connect(antelope_bridge).refundsSuccessful([0, 1])).to.emit(evm_bridge, 'BridgeFromAntelopeRefunded').withArgs(1);
+        });
+        it("Should find the refund moved by a removal by id" , async function () {
+            expect(await register.addPair(token.address, ANTELOPE_DECIMALS, ANTELOPE_ISSUER_NAME, ANTELOPE_ACCOUNT_NAME, ANTELOPE_SYMBOL_NAME)).to.emit("PairAdded");
+            for(var i = 0; i < 3; i++){
+                expect(await evm_bridge.connect(antelope_bridge).bridgeTo(token.address, "0x0000000000000000000000000000000000000000", ONE_TLOS, ANTELOPE_ISSUER_NAME)).to.emit('BridgeFromAntelopeFailed');
+            }
+            expect(await evm_bridge.connect(antelope_bridge).refundSuccessful(0)).to.emit('BridgeFromAntelopeRefunded');
+            await expect(evm_bridge.connect(antelope_bridge).refundSuccessful(2)).to.emit(evm_bridge, 'BridgeFromAntelopeRefunded').withArgs(2);
+            await expect(evm_bridge.connect(antelope_bridge).refundSuccessful(1)).to.emit(evm_bridge, 'BridgeFromAntelopeRefunded').withArgs(1);
+        });
+        it("Should not let random addresses call the refund success callback for several refunds" , async function () {
+            await expect(evm_bridge.connect(user).refundsSuccessful([0])).to.be.revertedWith('Only the Antelope bridge EVM address can trigger this method !');
+        });
+        it("Should let antelope bridge mint a batch, refunding the items that could not be minted" , async function () {
+            expect(await register.addPair(token.address, ANTELOPE_DECIMALS, ANTELOPE_ISSUER_NAME, ANTELOPE_ACCOUNT_NAME, ANTELOPE_SYMBOL_NAME)).to.emit("PairAdded");
+            await expect(evm_bridge.connect(antelope_bridge).bridgeToBatch(
+                [token.address, token.address],
+                [user.address, "0x0000000000000000000000000000000000000000"],
+                [ONE_TLOS, ONE_TLOS],
+                [ANTELOPE_ISSUER_NAME, ANTELOPE_ISSUER_NAME],
+                [ANTELOPE_ACCOUNT_NAME, ANTELOPE_ACCOUNT_NAME],
+                [ANTELOPE_SYMBOL_NAME, ANTELOPE_SYMBOL_NAME]
+            )).to.emit(evm_bridge, 'BridgeFromAntelopeFailed');
+            expect(await token.balanceOf(user.address)).to.equal(ONE_TLOS);
+        });
+        it("Should refund the batch items of a paused pair" , async function () {
+            expect(await register.addPair(token.address, ANTELOPE_DECIMALS, ANTELOPE_ISSUER_NAME, ANTELOPE_ACCOUNT_NAME, ANTELOPE_SYMBOL_NAME)).to.emit("PairAdded");
+            expect(await register.pausePair(1)).to.emit("PairPaused");
+            await expect(evm_bridge.connect(antelope_bridge).bridgeToBatch([token.address], [user.address], [ONE_TLOS], [ANTELOPE_ISSUER_NAME], [ANTELOPE_ACCOUNT_NAME], [ANTELOPE_SYMBOL_NAME])).to.emit(evm_bridge, 'BridgeFromAntelopeFailed');
+            expect(await token.balanceOf(user.address)).to.equal(0);
+        });
+        it("Should refund the batch items of a removed pair to their Antelope token and mint the others" , async function () {
+            expect(await register.addPair(token.address, ANTELOPE_DECIMALS, ANTELOPE_ISSUER_NAME, ANTELOPE_ACCOUNT_NAME, ANTELOPE_SYMBOL_NAME)).to.emit("PairAdded");
+            expect(await register.addPair(token2.address, ANTELOPE_DECIMALS, ANTELOPE_ISSUER_NAME, "token2.brdg", ANTELOPE_SYMBOL_NAME + "B")).to.emit("PairAdded");
+            // Pair ids start at 1: this removes token's pair & leaves token2's
+            expect(await register.removePair(1)).to.emit("PairDeleted");
+            const tx = await evm_bridge.connect(antelope_bridge).bridgeToBatch(
+                [token.address, token2.address],
+                [user.address, user.address],
+                [ONE_TLOS, ONE_TLOS],
+                [ANTELOPE_ISSUER_NAME, ANTELOPE_ISSUER_NAME],
+                [ANTELOPE_ACCOUNT_NAME, "token2.brdg"],
+                [ANTELOPE_SYMBOL_NAME, ANTELOPE_SYMBOL_NAME + "B"]
+            );
+            await expect(tx).to.emit(evm_bridge, 'BridgeFromAntelopeFailed').withArgs(user.address, token.address, ONE_TLOS, ANTELOPE_ISSUER_NAME);
+            await expect(tx).to.emit(evm_bridge, 'BridgeFromAntelopeSucceeded').withArgs(user.address, token2.address, ONE_TLOS);
+            expect(await token.balanceOf(user.address)).to.equal(0);
+            expect(await token2.balanceOf(user.address)).to.equal(ONE_TLOS);
+            // The removed pair's item is the only refund & names the Antelope token it came from
+            const refund = await evm_bridge.refunds(0);
+            expect(refund.id).to.equal(0);
+            expect(refund.antelope_token).to.equal(ANTELOPE_ACCOUNT_NAME);
+            expect(refund.antelope_symbol).to.equal(ANTELOPE_SYMBOL_NAME);
+            expect(refund.receiver).to.equal(ANTELOPE_ISSUER_NAME);
+            expect(refund.evm_decimals).to.equal(await token.decimals());
+            await expect(evm_bridge.connect(antelope_bridge).refundsSuccessful([0])).to.emit(evm_bridge, 'BridgeFromAntelopeRefunded').withArgs(0);
+        });
+        it("Should not let a batch have arrays of different lengths" , async function () {
+            expect(await register.addPair(token.address, ANTELOPE_DECIMALS, ANTELOPE_ISSUER_NAME, ANTELOPE_ACCOUNT_NAME, ANTELOPE_SYMBOL_NAME)).to.emit("PairAdded");
+            await expect(evm_bridge.connect(antelope_bridge).bridgeToBatch([token.address], [user.address], [], [ANTELOPE_ISSUER_NAME], [ANTELOPE_ACCOUNT_NAME], [ANTELOPE_SYMBOL_NAME])).to.be.revertedWith('Batch arrays must have the same length');
+        });
+        it("Should not let random addresses mint a batch" , async function () {
+            expect(await register.addPair(token.address, ANTELOPE_DECIMALS, ANTELOPE_ISSUER_NAME, ANTELOPE_ACCOUNT_NAME, ANTELOPE_SYMBOL_NAME)).to.emit("PairAdded");
+            await expect(evm_bridge.connect(user).bridgeToBatch([token.address], [user.address], [ONE_TLOS], [ANTELOPE_ISSUER_NAME], [ANTELOPE_ACCOUNT_NAME], [ANTELOPE_SYMBOL_NAME])).to.be.revertedWith('Only the Antelope bridge EVM address can trigger this method !');
+        });
     });
 });